@@ -0,0 +1,87 @@
+﻿//AsyncTaskManager.cpp
+#include "AsyncTaskManager.h"
+#include <algorithm>
+
+
+AsyncTaskManager::AsyncTaskManager(size_t concurrency, size_t shardCount, bool fastStart)
+    : lookupCache(std::make_shared<LookupCache>()), pool(std::max<size_t>(concurrency, 1)) {
+    // 只有第一个连接负责建库建表和分片布局检查，其余连接在首次被借出时才建立，直接使用现有 schema
+    for (size_t i = 0; i < pool.size(); ++i) {
+        managers.push_back(std::make_unique<TaskManager>(shardCount, lookupCache, fastStart, i > 0 && !fastStart));
+    }
+    // 借出时从末尾取，第一个连接放在末尾优先使用
+    for (auto it = managers.rbegin(); it != managers.rend(); ++it) {
+        idle.push_back(it->get());
+    }
+}
+
+
+AsyncTaskManager::Lease::Lease(AsyncTaskManager& owner)
+    : manager(owner.acquire()), owner(owner) {}
+
+
+AsyncTaskManager::Lease::~Lease() {
+    owner.release(manager);
+}
+
+
+TaskManager& AsyncTaskManager::acquire() {
+    std::unique_lock<std::mutex> lock(idleMtx);
+    idleCv.wait(lock, [this] { return !idle.empty(); });
+    TaskManager* manager = idle.back();
+    idle.pop_back();
+    return *manager;
+}
+
+
+void AsyncTaskManager::release(TaskManager& manager) {
+    {
+        std::lock_guard<std::mutex> lock(idleMtx);
+        idle.push_back(&manager);
+    }
+    idleCv.notify_one();
+}
+
+
+std::future<OpResult> AsyncTaskManager::addTask(const std::string& title, const std::string& description, int priority, const std::string& dueDate) {
+    return submit([=](TaskManager& manager) {
+        return manager.addTask(title, description, priority, dueDate);
+    });
+}
+
+
+std::future<OpResult> AsyncTaskManager::deleteTask(int id) {
+    return pool.submit([this, id] {
+        Lease lease(*this);
+        std::unique_lock<std::shared_timed_mutex> lock(reorderMtx);
+        return lease.manager.deleteTask(id);
+    });
+}
+
+
+std::future<OpResult> AsyncTaskManager::updateTask(int id, const std::string& title, const std::string& description, int priority, const std::string& dueDate) {
+    return submit([=](TaskManager& manager) {
+        return manager.updateTask(id, title, description, priority, dueDate);
+    });
+}
+
+
+std::future<OpResult> AsyncTaskManager::updateTaskStatus(int id, const std::string& status) {
+    return submit([=](TaskManager& manager) {
+        return manager.updateTaskStatus(id, status);
+    });
+}
+
+
+std::future<QueryResult> AsyncTaskManager::listTasks(int sortOption) {
+    return submit([=](TaskManager& manager) {
+        return manager.listTasks(sortOption);
+    });
+}
+
+
+std::future<QueryResult> AsyncTaskManager::listTasksByStatus(const std::string& status) {
+    return submit([=](TaskManager& manager) {
+        return manager.listTasksByStatus(status);
+    });
+}
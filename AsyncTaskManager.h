@@ -0,0 +1,79 @@
+﻿//AsyncTaskManager.h
+#ifndef ASYNCTASKMANAGER_H
+#define ASYNCTASKMANAGER_H
+
+
+#include "TaskManager.h"
+#include "ThreadPool.h"
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+
+// TaskManager 的异步版本
+// 持有一个小型执行器线程池和同样数量的数据库连接（每个连接一个 TaskManager），
+// 每个操作立即返回 std::future，最多 concurrency 个操作同时在数据库上执行
+class AsyncTaskManager {
+public:
+    // 默认只有第一个连接在构造时建立并初始化数据库，其余连接首次被使用时才建立；
+    // fastStart 为 true 时所有连接都在首次被使用时才建立（见 TaskManager）
+    explicit AsyncTaskManager(size_t concurrency = 4, size_t shardCount = 1, bool fastStart = false);
+
+    AsyncTaskManager(const AsyncTaskManager&) = delete;
+    AsyncTaskManager& operator=(const AsyncTaskManager&) = delete;
+
+    size_t concurrency() const { return managers.size(); }
+
+    // 所有连接共享的点查询缓存
+    const LookupCache& cache() const { return *lookupCache; }
+
+    std::future<OpResult> addTask(const std::string& title, const std::string& description, int priority, const std::string& dueDate);
+    std::future<OpResult> deleteTask(int id);
+    std::future<OpResult> updateTask(int id, const std::string& title, const std::string& description, int priority, const std::string& dueDate);
+    std::future<OpResult> updateTaskStatus(int id, const std::string& status);
+    std::future<QueryResult> listTasks(int sortOption = 0);
+    std::future<QueryResult> listTasksByStatus(const std::string& status);
+
+    // 在某个空闲连接上执行任意操作
+    template <typename F>
+    auto submit(F f) -> std::future<typename std::result_of<F(TaskManager&)>::type> {
+        return pool.submit([this, f]() mutable {
+            Lease lease(*this);
+            std::shared_lock<std::shared_timed_mutex> lock(reorderMtx);
+            return f(lease.manager);
+        });
+    }
+
+private:
+    // 从连接池借出一个 TaskManager，析构时归还
+    class Lease {
+    public:
+        explicit Lease(AsyncTaskManager& owner);
+        ~Lease();
+        TaskManager& manager;
+    private:
+        AsyncTaskManager& owner;
+    };
+
+    TaskManager& acquire();
+    void release(TaskManager& manager);
+
+    std::shared_ptr<LookupCache> lookupCache;
+    std::vector<std::unique_ptr<TaskManager>> managers;
+    std::vector<TaskManager*> idle;
+    std::mutex idleMtx;
+    std::condition_variable idleCv;
+
+    // 删除会重整所有任务ID，必须独占执行；其他操作共享执行
+    std::shared_timed_mutex reorderMtx;
+
+    ThreadPool pool; // 最后声明，析构时先等待所有任务结束
+};
+
+
+#endif // ASYNCTASKMANAGER_H
@@ -0,0 +1,125 @@
+﻿//ChangeFeed.cpp
+#include "ChangeFeed.h"
+#include "TaskRenderer.h"
+#include <algorithm>
+#include <sstream>
+
+
+const size_t ChangeFeed::CAPACITY;
+
+
+const char* changeTypeName(ChangeType type) {
+    switch (type) {
+        case ChangeType::Add: return "add";
+        case ChangeType::Update: return "update";
+        case ChangeType::Status: return "status";
+        case ChangeType::Delete: return "delete";
+        case ChangeType::Reindex: return "reindex";
+    }
+    return "unknown";
+}
+
+
+std::string ChangeEvent::toString() const {
+    std::ostringstream oss;
+    oss << seq << '\t' << changeTypeName(type) << '\t' << task.id << '\t'
+        << escapeTsv(task.title) << '\t' << task.priority << '\t'
+        << escapeTsv(task.dueDate) << '\t' << escapeTsv(task.status) << '\t'
+        << escapeTsv(task.description);
+    return oss.str();
+}
+
+
+ChangeFeed& ChangeFeed::getInstance() {
+    static ChangeFeed instance;
+    return instance;
+}
+
+
+uint64_t ChangeFeed::publish(ChangeType type, const Task& task) {
+    std::lock_guard<std::mutex> publishLock(publishMtx);
+    ChangeEvent event{0, type, task};
+    std::vector<Callback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        event.seq = next++;
+        events.push_back(event);
+        if (events.size() > CAPACITY) {
+            events.pop_front();
+        }
+        for (const auto& entry : subscribers) {
+            callbacks.push_back(entry.second);
+        }
+    }
+    cv.notify_all();
+
+    for (const auto& callback : callbacks) {
+        callback(event);
+    }
+    return event.seq;
+}
+
+
+std::vector<ChangeEvent> ChangeFeed::readFrom(uint64_t offset, size_t maxEvents, bool* truncated) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<ChangeEvent> result;
+
+    uint64_t first = events.empty() ? next : events.front().seq;
+    if (truncated) {
+        *truncated = offset < first && first > 1;
+    }
+    if (offset < first) {
+        offset = first;
+    }
+    if (offset >= next) {
+        return result;
+    }
+
+    size_t start = static_cast<size_t>(offset - first);
+    size_t count = std::min(maxEvents, events.size() - start);
+    result.reserve(count);
+    for (size_t i = start; i < start + count; ++i) {
+        result.push_back(events[i]);
+    }
+    return result;
+}
+
+
+bool ChangeFeed::waitFor(uint64_t offset, std::chrono::milliseconds timeout) const {
+    std::unique_lock<std::mutex> lock(mtx);
+    return cv.wait_for(lock, timeout, [&] { return next > offset; });
+}
+
+
+uint64_t ChangeFeed::firstSeq() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return events.empty() ? next : events.front().seq;
+}
+
+
+uint64_t ChangeFeed::nextSeq() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return next;
+}
+
+
+int ChangeFeed::subscribe(uint64_t fromOffset, Callback callback, bool* truncated) {
+    // 持有 publishMtx 期间补发历史事件，避免与实时事件交错或遗漏
+    std::lock_guard<std::mutex> publishLock(publishMtx);
+    for (const auto& event : readFrom(fromOffset, CAPACITY, truncated)) {
+        callback(event);
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    int id = nextSubscriberId++;
+    subscribers[id] = std::move(callback);
+    return id;
+}
+
+
+void ChangeFeed::unsubscribe(int subscriptionId) {
+    // 等待正在执行的回调结束，返回后不会再回调该订阅
+    std::lock_guard<std::mutex> publishLock(publishMtx);
+    std::lock_guard<std::mutex> lock(mtx);
+    subscribers.erase(subscriptionId);
+}
@@ -0,0 +1,87 @@
+﻿//ChangeFeed.h
+#ifndef CHANGEFEED_H
+#define CHANGEFEED_H
+
+
+#include "Task.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+// 任务变更类型
+enum class ChangeType {
+    Add,      // 新增任务
+    Update,   // 修改标题/描述/优先级/截止日期
+    Status,   // 修改状态
+    Delete,   // 删除任务
+    Reindex   // 删除后ID重整，订阅方需要全量重新同步
+};
+
+const char* changeTypeName(ChangeType type);
+
+
+// 单条变更事件
+struct ChangeEvent {
+    uint64_t seq;   // 全局递增序号，从1开始
+    ChangeType type;
+    Task task;      // 变更后的任务快照（Delete 只有 id 有效，Reindex 不携带任务）
+
+    // 序列化为一行TSV: seq, type, id, title, priority, due_date, status, description
+    std::string toString() const;
+};
+
+
+// 有界、带序号的任务变更流
+// 只保留最近 CAPACITY 条事件；订阅方按偏移量（下一条想要的序号）增量读取
+class ChangeFeed {
+public:
+    static const size_t CAPACITY = 4096;
+
+    using Callback = std::function<void(const ChangeEvent&)>;
+
+    // 获取单例实例
+    static ChangeFeed& getInstance();
+
+    // 禁止拷贝和赋值
+    ChangeFeed(const ChangeFeed&) = delete;
+    ChangeFeed& operator=(const ChangeFeed&) = delete;
+
+    // 发布事件，返回分配的序号。回调在发布线程同步执行，回调内不可再次发布
+    uint64_t publish(ChangeType type, const Task& task);
+
+    // 从 offset 开始读取最多 maxEvents 条事件
+    // 若 offset 早于缓冲区中最早的事件，*truncated 置为 true，从最早的事件开始返回
+    std::vector<ChangeEvent> readFrom(uint64_t offset, size_t maxEvents, bool* truncated = nullptr) const;
+
+    // 等待直到序号 offset 的事件出现或超时，返回是否有新事件
+    bool waitFor(uint64_t offset, std::chrono::milliseconds timeout) const;
+
+    uint64_t firstSeq() const; // 缓冲区中最早事件的序号
+    uint64_t nextSeq() const;  // 下一条事件将使用的序号
+
+    // 从 fromOffset 开始订阅：先补发缓冲区中的历史事件，再接收实时事件
+    // 若 fromOffset 对应的事件已被淘汰，*truncated 置为 true，补发从最早的事件开始，订阅方应全量重新同步
+    int subscribe(uint64_t fromOffset, Callback callback, bool* truncated = nullptr);
+    void unsubscribe(int subscriptionId); // 不可在回调内调用
+
+private:
+    ChangeFeed() = default;
+
+    mutable std::mutex mtx;
+    mutable std::condition_variable cv;
+    std::mutex publishMtx; // 保证回调按序号顺序执行
+    std::deque<ChangeEvent> events;
+    uint64_t next = 1;
+    std::map<int, Callback> subscribers;
+    int nextSubscriberId = 1;
+};
+
+
+#endif // CHANGEFEED_H
@@ -0,0 +1,212 @@
+﻿//ChangeFeedServer.cpp
+#include "ChangeFeedServer.h"
+#include "ChangeFeed.h"
+#include "Logger.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+namespace {
+
+const size_t BATCH_SIZE = 256;
+const std::chrono::milliseconds POLL_INTERVAL(500);
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 读取客户端发送的第一行（起始偏移量）
+bool readLine(int fd, std::string& line) {
+    char c;
+    line.clear();
+    while (true) {
+        ssize_t n = ::recv(fd, &c, 1, 0);
+        if (n <= 0) {
+            return false;
+        }
+        if (c == '\n') {
+            return true;
+        }
+        if (c != '\r') {
+            line += c;
+        }
+    }
+}
+
+// 尝试连接已存在的套接字文件：能连上说明另一个进程仍在服务
+bool socketInUse(const sockaddr_un& addr) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    bool inUse = ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+    ::close(fd);
+    return inUse;
+}
+
+} // namespace
+
+
+const size_t ChangeFeedServer::MAX_CLIENTS;
+
+
+ChangeFeedServer::ChangeFeedServer(const std::string& socketPath) : path(socketPath) {}
+
+
+ChangeFeedServer::~ChangeFeedServer() {
+    stop();
+}
+
+
+bool ChangeFeedServer::start() {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "变更流套接字路径过长: " << path << std::endl;
+        return false;
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (socketInUse(addr)) {
+        Logger::getInstance().log("变更流套接字已被其他进程使用: " + path);
+        return false;
+    }
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        Logger::getInstance().log("变更流套接字创建失败: " + std::string(std::strerror(errno)));
+        return false;
+    }
+    ::unlink(path.c_str()); // 只剩上次异常退出遗留的套接字文件
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listenFd, 8) < 0) {
+        Logger::getInstance().log("变更流套接字监听失败: " + std::string(std::strerror(errno)));
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    running = true;
+    acceptThread = std::thread(&ChangeFeedServer::acceptLoop, this);
+    Logger::getInstance().log("变更流服务已启动: " + path);
+    return true;
+}
+
+
+void ChangeFeedServer::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    // 关闭监听套接字和所有客户端连接，使阻塞中的 accept/recv/send 立即返回
+    ::shutdown(listenFd, SHUT_RDWR);
+    if (acceptThread.joinable()) {
+        acceptThread.join();
+    }
+    ::close(listenFd);
+    listenFd = -1;
+    {
+        std::lock_guard<std::mutex> lock(clientsMtx);
+        for (int fd : clientFds) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+    }
+    for (auto& client : clients) {
+        if (client.thread.joinable()) {
+            client.thread.join();
+        }
+    }
+    clients.clear();
+    ::unlink(path.c_str());
+    Logger::getInstance().log("变更流服务已停止。");
+}
+
+
+void ChangeFeedServer::acceptLoop() {
+    while (running) {
+        int clientFd = ::accept(listenFd, nullptr, nullptr);
+        if (clientFd < 0) {
+            if (!running) {
+                break;
+            }
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(clientsMtx);
+        reapFinishedClients();
+        if (clients.size() >= MAX_CLIENTS) {
+            sendAll(clientFd, "# too many clients\n");
+            ::close(clientFd);
+            Logger::getInstance().log("变更流客户端数量已达上限，拒绝新连接");
+            continue;
+        }
+        clientFds.insert(clientFd);
+        clients.emplace_back();
+        Client* client = &clients.back();
+        client->thread = std::thread(&ChangeFeedServer::serveClient, this, clientFd, client);
+    }
+}
+
+
+void ChangeFeedServer::reapFinishedClients() {
+    for (auto it = clients.begin(); it != clients.end();) {
+        if (it->done) {
+            it->thread.join(); // done 在线程最后设置，join 立即返回
+            it = clients.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+
+void ChangeFeedServer::serveClient(int clientFd, Client* client) {
+    ChangeFeed& feed = ChangeFeed::getInstance();
+    std::string line;
+    bool ok = readLine(clientFd, line);
+    uint64_t offset = feed.nextSeq();
+    if (ok && !line.empty()) {
+        try {
+            offset = std::stoull(line);
+        } catch (const std::exception&) {
+            sendAll(clientFd, "# invalid offset\n");
+            ok = false;
+        }
+    }
+
+    while (ok && running) {
+        bool truncated = false;
+        std::vector<ChangeEvent> batch = feed.readFrom(offset, BATCH_SIZE, &truncated);
+        std::string out;
+        if (truncated) {
+            out += "# truncated " + std::to_string(batch.empty() ? feed.firstSeq() : batch.front().seq) + "\n";
+        }
+        for (const auto& event : batch) {
+            out += event.toString();
+            out += '\n';
+            offset = event.seq + 1;
+        }
+        if (!out.empty() && !sendAll(clientFd, out)) {
+            break;
+        }
+        if (batch.empty()) {
+            feed.waitFor(offset, POLL_INTERVAL);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(clientsMtx);
+    clientFds.erase(clientFd);
+    ::close(clientFd);
+    client->done = true;
+}
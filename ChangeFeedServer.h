@@ -0,0 +1,53 @@
+﻿//ChangeFeedServer.h
+#ifndef CHANGEFEEDSERVER_H
+#define CHANGEFEEDSERVER_H
+
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+
+// 通过本地 Unix 套接字对外提供变更流
+// 协议: 客户端连接后发送一行起始偏移量（空行表示从当前最新位置开始），
+// 服务端随后持续推送 ChangeEvent::toString() 格式的事件行；
+// 若偏移量已被淘汰，先推送一行 "# truncated <最早序号>"，客户端应全量重新同步
+class ChangeFeedServer {
+public:
+    explicit ChangeFeedServer(const std::string& socketPath);
+    ~ChangeFeedServer();
+
+    ChangeFeedServer(const ChangeFeedServer&) = delete;
+    ChangeFeedServer& operator=(const ChangeFeedServer&) = delete;
+
+    bool start(); // 套接字路径已有存活的服务时返回 false，不会抢占
+    void stop();
+
+    // 同时服务的客户端上限，超出时新连接收到 "# too many clients" 后被关闭
+    static const size_t MAX_CLIENTS = 64;
+
+private:
+    struct Client {
+        std::thread thread;
+        std::atomic<bool> done{false};
+    };
+
+    void acceptLoop();
+    void serveClient(int clientFd, Client* client);
+    void reapFinishedClients(); // 回收已结束的客户端线程，调用方需持有 clientsMtx
+
+    std::string path;
+    int listenFd = -1;
+    std::atomic<bool> running{false};
+    std::thread acceptThread;
+
+    std::mutex clientsMtx;
+    std::set<int> clientFds;
+    std::list<Client> clients; // list 保证元素地址不变，供客户端线程设置 done
+};
+
+
+#endif // CHANGEFEEDSERVER_H
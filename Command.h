@@ -8,7 +8,8 @@
 
 class CommandBase{
 public:
-    virtual void execute(const std::string& args) = 0;
+    virtual ~CommandBase() = default;
+    virtual bool execute(const std::string& args) = 0; // 返回命令是否执行成功
 };
 
 
@@ -16,23 +17,71 @@ public:
 template <typename Derived>
 class Command :public CommandBase{
 public:
-    void execute(const std::string& args) {
-        static_cast<Derived*>(this)->executeImpl(args);
+    bool execute(const std::string& args) {
+        return static_cast<Derived*>(this)->executeImpl(args);
     }
 };
 
 
 // 具体命令类示例
-#include "TaskManager.h"
+#include "AsyncTaskManager.h"
 #include "Logger.h"
+#include "ChangeFeed.h"
+#include "QueryEngine.h"
+#include "TaskSnapshot.h"
+#include "TableFormatter.h"
+#include "TaskRenderer.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+
+
+// 状态的中文名称
+inline const char* statusLabel(const std::string& status) {
+    if (status == "pending") return "待处理";
+    if (status == "in_progress") return "进行中";
+    if (status == "completed") return "已完成";
+    return "";
+}
+
+// 输出失败信息
+inline void printFailure(const OpResult& result) {
+    if (result.status == OpStatus::Error) {
+        std::cerr << result.message << std::endl;
+    } else {
+        std::cout << result.message << std::endl;
+    }
+}
+
+// 在某个数据库连接上打开惰性行视图并直接渲染，不物化整张结果表，返回是否成功
+template <typename Open>
+bool renderQuery(AsyncTaskManager& taskManager, TaskRenderer& renderer, const std::string& title, Open open) {
+    std::string error = taskManager.submit([&](TaskManager& manager) -> std::string {
+        try {
+            TaskRows rows = open(manager);
+            renderer.render(title, rows);
+            return "";
+        } catch (sql::SQLException& e) {
+            Logger::getInstance().log("查询任务失败: " + std::string(e.what()));
+            return "查询任务失败: " + std::string(e.what());
+        }
+    }).get();
+    if (!error.empty()) {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    return true;
+}
 
 
 // 添加任务命令
 class AddCommand : public Command<AddCommand> {
 public:
-    AddCommand(TaskManager& manager) : taskManager(manager) {}
-    void executeImpl(const std::string& args) {
+    AddCommand(AsyncTaskManager& manager) : taskManager(manager) {}
+    bool executeImpl(const std::string& args) {
         // 简单的参数解析：标题，描述,优先级,截止日期
         size_t pos1 = args.find(',');
         size_t pos2 = args.find(',', pos1 + 1);
@@ -40,70 +89,128 @@ public:
 
         if (pos1 == std::string::npos || pos2 == std::string::npos) {
             std::cout << "参数格式错误。请使用: add <标题>,<描述>,<优先级>,<截止日期>" << std::endl;
-            return;
+            return false;
         }
         std::string title = args.substr(0, pos1);
         std::string description = args.substr(pos1 + 1, pos2 - pos1 - 1);
         int priority = std::stoi(args.substr(pos2 + 1, pos3 - pos2 - 1));
         std::string dueDate = args.substr(pos3 + 1);
-        taskManager.addTask(title,description, priority, dueDate);
+        OpResult result = taskManager.addTask(title,description, priority, dueDate).get();
+        if (!result.ok()) {
+            printFailure(result);
+            return false;
+        }
         std::cout << "任务添加成功。" << std::endl;
+        return true;
     }
 private:
-    TaskManager& taskManager;
+    AsyncTaskManager& taskManager;
 };
 
 
 // 删除任务命令
 class DeleteCommand : public Command<DeleteCommand> {
 public:
-    DeleteCommand(TaskManager& manager) : taskManager(manager) {}
-    void executeImpl(const std::string& args) {
+    DeleteCommand(AsyncTaskManager& manager) : taskManager(manager) {}
+    bool executeImpl(const std::string& args) {
         try{
             size_t pos;
             int id = std::stoi(args, &pos);
             if(pos != args.length()){
                 std::cout << "参数格式错误。请使用: delete <ID>" << std::endl;
-                return;
+                return false;
             }
-            taskManager.deleteTask(id);
-            
+            OpResult result = taskManager.deleteTask(id).get();
+            if (!result.ok()) {
+                printFailure(result);
+                return false;
+            }
+            std::cout << "任务删除成功。" << std::endl;
+            return true;
+
         }catch(const std::invalid_argument& e){
             std::cout << "参数格式错误。请使用: delete <ID>" << std::endl;
-            return;
+            return false;
         }catch(const std::out_of_range& e){
             std::cout << "ID超出范围。请使用有效的任务ID。" << std::endl;
-            return;
+            return false;
         }
 
 
     }
 private:
-    TaskManager& taskManager;
+    AsyncTaskManager& taskManager;
 };
 
 
 // 列出任务命令
 class ListCommand : public Command<ListCommand> {
 public:
-    ListCommand(TaskManager& manager) : taskManager(manager) {}
-    void executeImpl(const std::string& args) {
+    ListCommand(AsyncTaskManager& manager) : taskManager(manager) {}
+    bool executeImpl(const std::string& args) {
+        // 参数格式: [排序选项] [输出格式: table|tsv|json]
         int sortOption = 0;
-        if (!args.empty()) {
-            sortOption = std::stoi(args);
+        std::string format;
+        std::istringstream iss(args);
+        std::string token;
+        while (iss >> token) {
+            if (std::isdigit(static_cast<unsigned char>(token[0]))) {
+                sortOption = std::stoi(token);
+            } else {
+                format = token;
+            }
+        }
+
+        std::unique_ptr<TaskRenderer> renderer = makeRenderer(format, std::cout);
+        if (!renderer) {
+            std::cout << "未知输出格式。可用格式: table, tsv, json" << std::endl;
+            return false;
+        }
+        return renderQuery(taskManager, *renderer, "任务列表:", [sortOption](TaskManager& manager) {
+            return manager.openTasks(sortOption);
+        });
+    }
+private:
+    AsyncTaskManager& taskManager;
+};
+
+
+// 按状态筛选任务命令
+class FilterCommand : public Command<FilterCommand> {
+public:
+    FilterCommand(AsyncTaskManager& manager) : taskManager(manager) {}
+    bool executeImpl(const std::string& args) {
+        // 参数格式: <状态> [输出格式: table|tsv|json]
+        std::istringstream iss(args);
+        std::string status, format;
+        iss >> status >> format;
+
+        TaskStatus parsed;
+        if (!parseStatus(status, parsed)) {
+            std::cout << "参数格式错误。请使用: filter <状态> [格式]" << std::endl;
+            std::cout << "可用状态: pending, in_progress, completed" << std::endl;
+            return false;
         }
-        taskManager.listTasks(sortOption);
+        std::unique_ptr<TaskRenderer> renderer = makeRenderer(format, std::cout, "没有找到相应状态的任务。");
+        if (!renderer) {
+            std::cout << "未知输出格式。可用格式: table, tsv, json" << std::endl;
+            return false;
+        }
+        std::string title = "状态为 '" + std::string(statusLabel(status)) + "' 的任务列表:";
+        return renderQuery(taskManager, *renderer, title, [status](TaskManager& manager) {
+            return manager.openTasksByStatus(status);
+        });
     }
 private:
-    TaskManager& taskManager;
+    AsyncTaskManager& taskManager;
 };
 
 
 // 更新任务命令
 class UpdateCommand : public Command<UpdateCommand> {
 public:
-    UpdateCommand(TaskManager& manager) : taskManager(manager) {}
-    void executeImpl(const std::string& args) {
+    UpdateCommand(AsyncTaskManager& manager) : taskManager(manager) {}
+    bool executeImpl(const std::string& args) {
         // 参数格式: ID,描述,优先级,截止日期
         size_t pos1 = args.find(',');
         size_t pos2 = args.find(',', pos1 + 1);
@@ -112,7 +219,7 @@ public:
 
         if (pos1 == std::string::npos || pos2 == std::string::npos || pos3 == std::string::npos|| pos4 == std::string::npos) {
             std::cout << "参数格式错误。请使用: update <ID>,<标题>,<描述>,<优先级>,<截止日期>" << std::endl;
-            return;
+            return false;
         }
         int id = std::stoi(args.substr(0, pos1));
         std::string title= args.substr(pos1 + 1, pos2 - pos1 - 1);
@@ -120,25 +227,30 @@ public:
         int priority = std::stoi(args.substr(pos3 + 1, pos4 - pos3 - 1));
         std::string dueDate = args.substr(pos4 + 1);
 
-        taskManager.updateTask(id,title, description, priority, dueDate);
-        
+        OpResult result = taskManager.updateTask(id,title, description, priority, dueDate).get();
+        if (!result.ok()) {
+            printFailure(result);
+            return false;
+        }
+        std::cout << "任务更新成功。" << std::endl;
+        return true;
     }
 private:
-    TaskManager& taskManager;
+    AsyncTaskManager& taskManager;
 };
 
 // 更新任务状态命令
 class UpdateStatusCommand : public Command<UpdateStatusCommand> {
 public:
-    UpdateStatusCommand(TaskManager& manager) : taskManager(manager) {}
+    UpdateStatusCommand(AsyncTaskManager& manager) : taskManager(manager) {}
     
-    void executeImpl(const std::string& args) {
+    bool executeImpl(const std::string& args) {
         // 参数格式: ID,状态
         size_t pos = args.find(',');
         if (pos == std::string::npos) {
             std::cout << "参数格式错误。请使用: status <ID>,<状态>" << std::endl;
             std::cout << "可用状态: pending, in_progress, completed" << std::endl;
-            return;
+            return false;
         }
         
         try {
@@ -146,22 +258,170 @@ public:
             std::string status = args.substr(pos + 1);
             
             // 验证状态值
-            if (status != "pending" && status != "in_progress" && status != "completed") {
+            TaskStatus parsed;
+            if (!parseStatus(status, parsed)) {
                 std::cout << "无效状态。可用状态: pending, in_progress, completed" << std::endl;
-                return;
+                return false;
+            }
+            
+            OpResult result = taskManager.updateTaskStatus(id, status).get();
+            if (!result.ok()) {
+                printFailure(result);
+                return false;
             }
+            std::cout << "任务状态更新成功！" << std::endl;
             
-            taskManager.updateTaskStatus(id, status);
+            // 显示状态变更信息
+            std::cout << "任务 '" << result.task.title << "' 的状态已更新为: "
+                      << statusLabel(status) << std::endl;
+            return true;
             
         } catch(const std::invalid_argument& e) {
             std::cout << "参数格式错误。请使用: status <ID>,<状态>" << std::endl;
         } catch(const std::out_of_range& e) {
             std::cout << "ID超出范围。请使用有效的任务ID。" << std::endl;
         }
+        return false;
     }
     
 private:
-    TaskManager& taskManager;
+    AsyncTaskManager& taskManager;
+};
+
+// 查看变更流命令
+class WatchCommand : public Command<WatchCommand> {
+public:
+    bool executeImpl(const std::string& args) {
+        // 参数格式: [起始偏移量]；省略时从上次 watch 的位置继续
+        if (!args.empty()) {
+            try {
+                offset = std::stoull(args);
+            } catch (const std::exception& e) {
+                std::cout << "参数格式错误。请使用: watch [偏移量]" << std::endl;
+                return false;
+            }
+        }
+
+        ChangeFeed& feed = ChangeFeed::getInstance();
+        bool truncated = false;
+        std::vector<ChangeEvent> events = feed.readFrom(offset, ChangeFeed::CAPACITY, &truncated);
+        if (truncated) {
+            std::cout << "偏移量 " << offset << " 之前的事件已被淘汰，请重新执行 list 全量同步。" << std::endl;
+        }
+        for (const auto& event : events) {
+            std::cout << event.toString() << std::endl;
+            offset = event.seq + 1;
+        }
+        if (events.empty()) {
+            offset = std::max<uint64_t>(offset, feed.firstSeq());
+            std::cout << "没有新的变更。" << std::endl;
+        }
+        std::cout << "下一偏移量: " << offset << std::endl;
+        return true;
+    }
+
+private:
+    uint64_t offset = 0; // 下一条要读取的事件序号
+};
+
+// 统计报表命令
+class ReportCommand : public Command<ReportCommand> {
+public:
+    ReportCommand(AsyncTaskManager& manager, ThreadPool& pool) : taskManager(manager), engine(pool) {}
+
+    bool executeImpl(const std::string& args) {
+        // 参数格式: [YYYY-MM-DD]，指定计算逾期时使用的“今天”
+        int32_t today = QueryEngine::today();
+        if (!args.empty()) {
+            today = parseDueDate(args);
+            if (today == NO_DUE_DATE) {
+                std::cout << "参数格式错误。请使用: report [YYYY-MM-DD]" << std::endl;
+                return false;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        SyncResult sync = taskManager.submit([this](TaskManager& manager) {
+            return snapshot.refresh(manager);
+        }).get();
+        if (sync == SyncResult::Failed) {
+            std::cerr << "生成报表失败: " << snapshot.error() << std::endl;
+            return false;
+        }
+        auto synced = std::chrono::steady_clock::now();
+
+        const TaskStore& store = snapshot.store();
+        TaskReport report = engine.aggregate(store, today);
+        std::vector<uint32_t> upcoming = engine.upcoming(store, UPCOMING_LIMIT);
+        auto end = std::chrono::steady_clock::now();
+
+        std::cout << "任务统计:" << std::endl;
+        std::cout << "总数: " << report.total
+                  << "  待处理: " << report.byStatus[static_cast<int>(TaskStatus::Pending)]
+                  << "  进行中: " << report.byStatus[static_cast<int>(TaskStatus::InProgress)]
+                  << "  已完成: " << report.byStatus[static_cast<int>(TaskStatus::Completed)]
+                  << "  逾期未完成: " << report.overdue << std::endl;
+
+        std::cout << "\n按优先级统计:" << std::endl;
+        std::cout << std::left
+                  << TableFormatter::padToWidth("优先级", 8) << " | "
+                  << TableFormatter::padToWidth("待处理", 8) << " | "
+                  << TableFormatter::padToWidth("进行中", 8) << " | "
+                  << TableFormatter::padToWidth("已完成", 8) << " | "
+                  << TableFormatter::padToWidth("逾期", 8) << std::endl;
+        std::cout << std::string(52, '-') << std::endl;
+        for (size_t p = 0; p < report.byPriority.size(); ++p) {
+            const auto& counts = report.byPriority[p];
+            if (counts[0] + counts[1] + counts[2] == 0) {
+                continue;
+            }
+            std::cout << TableFormatter::padToWidth(std::to_string(p), 8) << " | "
+                      << TableFormatter::padToWidth(std::to_string(counts[0]), 8) << " | "
+                      << TableFormatter::padToWidth(std::to_string(counts[1]), 8) << " | "
+                      << TableFormatter::padToWidth(std::to_string(counts[2]), 8) << " | "
+                      << TableFormatter::padToWidth(std::to_string(report.overdueByPriority[p]), 8)
+                      << std::endl;
+        }
+
+        std::cout << "\n最近到期的未完成任务:" << std::endl;
+        TableFormatter::printHeader();
+        for (uint32_t row : upcoming) {
+            std::cout << store.get(row).toString() << std::endl;
+        }
+
+        std::cout << "\n" << (sync == SyncResult::Reloaded ? "快照已从数据库全量加载" : "快照已通过变更流增量同步")
+                  << "，同步耗时 " << std::chrono::duration<double, std::milli>(synced - start).count()
+                  << " ms，统计耗时 " << std::chrono::duration<double, std::milli>(end - synced).count()
+                  << " ms" << std::endl;
+        return true;
+    }
+
+private:
+    static const size_t UPCOMING_LIMIT = 5;
+
+    AsyncTaskManager& taskManager;
+    QueryEngine engine;
+    TaskSnapshot snapshot;
+};
+
+// 查看点查询缓存统计命令
+class CacheCommand : public Command<CacheCommand> {
+public:
+    CacheCommand(AsyncTaskManager& manager) : taskManager(manager) {}
+
+    bool executeImpl(const std::string& /*args*/) {
+        LookupCache::Stats stats = taskManager.cache().stats();
+        std::cout << "点查询缓存统计:" << std::endl;
+        std::cout << "命中: " << stats.hits << "  负缓存命中: " << stats.negativeHits
+                  << "  未命中: " << stats.misses << std::endl;
+        std::cout << "命中率: " << std::fixed << std::setprecision(1) << stats.hitRate() * 100 << "%"
+                  << std::defaultfloat << std::endl;
+        std::cout << "淘汰: " << stats.evictions << "  过期: " << stats.expirations << "  容量: " << stats.size << "/" << stats.capacity << std::endl;
+        return true;
+    }
+
+private:
+    AsyncTaskManager& taskManager;
 };
 
 #endif // COMMAND_H
@@ -0,0 +1,30 @@
+﻿//DatabaseConfig.h
+#ifndef DATABASECONFIG_H
+#define DATABASECONFIG_H
+
+
+// 修改为你的数据库连接信息
+const char* const DB_URL = "tcp://127.0.0.1:3306";
+const char* const DB_USER = "taskuser";
+const char* const DB_PASSWORD = "12345";
+const char* const DB_SCHEMA = "task_manager"; // 分片模式下也是0号分片
+
+// 任务表结构（单库与各分片共用）
+const char* const TASKS_TABLE_DDL =
+    "CREATE TABLE IF NOT EXISTS tasks ("
+    "task_id INT AUTO_INCREMENT PRIMARY KEY, "
+    "title VARCHAR(255) NOT NULL DEFAULT 'Task', "
+    "description TEXT, "
+    "status ENUM('pending', 'in_progress', 'completed') DEFAULT 'pending', "
+    "priority INT DEFAULT 2 COMMENT '1-高, 2-中, 3-低', "
+    "due_date DATE, "
+    "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP, "
+    "updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP"
+    ")";
+
+// 修改上面的表结构时递增，使快速启动重新执行DDL（见 SchemaVersion.h）
+const int SCHEMA_VERSION = 1;
+const char* const SCHEMA_VERSION_FILE = ".schema_version";
+
+
+#endif // DATABASECONFIG_H
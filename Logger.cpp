@@ -12,14 +12,25 @@ Logger& Logger::getInstance() {
 
 
 Logger::Logger() {
-    logFile.open("log.txt", std::ios::app);
-    if (!logFile.is_open()) {
-        std::cerr << "无法打开日志文件。" << std::endl;
-    }
+    // 打开文件可能因磁盘或网络文件系统而变慢，不阻塞启动路径
+    opening = std::async(std::launch::async, [this]() {
+        logFile.open("log.txt", std::ios::app);
+        if (!logFile.is_open()) {
+            std::cerr << "无法打开日志文件。" << std::endl;
+        }
+    });
 }
 
 
 Logger::~Logger() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!opened) {
+        opening.wait();
+        opened = true;
+        for (const auto& line : pending) {
+            writeLine(line);
+        }
+    }
     if (logFile.is_open()) {
         logFile.close();
     }
@@ -28,10 +39,27 @@ Logger::~Logger() {
 
 void Logger::log(const std::string& message) {
     std::lock_guard<std::mutex> lock(mtx);
+    // 获取当前时间（记录调用时刻，而不是实际写入时刻）
+    auto now = std::chrono::system_clock::now();
+    std::time_t now_time = std::chrono::system_clock::to_time_t(now);
+    std::string line = std::string(std::ctime(&now_time)) + ": " + message;
+    if (!opened) {
+        if (opening.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            pending.push_back(std::move(line));
+            return;
+        }
+        opened = true;
+        for (const auto& earlier : pending) {
+            writeLine(earlier);
+        }
+        pending.clear();
+    }
+    writeLine(line);
+}
+
+
+void Logger::writeLine(const std::string& line) {
     if (logFile.is_open()) {
-        // 获取当前时间
-        auto now = std::chrono::system_clock::now();
-        std::time_t now_time = std::chrono::system_clock::to_time_t(now);
-        logFile << std::ctime(&now_time) << ": " << message << std::endl;
+        logFile << line << std::endl;
     }
 }
@@ -5,7 +5,9 @@
 
 #include <string>
 #include <fstream>
+#include <future>
 #include <mutex>
+#include <vector>
 
 
 class Logger {
@@ -28,7 +30,13 @@ private:
     ~Logger();
 
 
+    void writeLine(const std::string& line);
+
+    // 日志文件在后台线程打开，打开完成前的日志先缓存在内存中
     std::ofstream logFile;
+    std::future<void> opening;
+    bool opened = false;
+    std::vector<std::string> pending;
     std::mutex mtx;
 };
 
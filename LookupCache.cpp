@@ -0,0 +1,137 @@
+﻿//LookupCache.cpp
+#include "LookupCache.h"
+#include <algorithm>
+
+
+const size_t LookupCache::DEFAULT_CAPACITY;
+constexpr std::chrono::milliseconds LookupCache::DEFAULT_TTL;
+constexpr std::chrono::milliseconds LookupCache::DEFAULT_NEGATIVE_TTL;
+
+
+LookupCache::LookupCache(size_t capacity, std::chrono::milliseconds ttl, std::chrono::milliseconds negativeTtl)
+    : slots(std::max<size_t>(capacity, 1)), ttl(ttl), negativeTtl(negativeTtl) {
+    index.reserve(slots.size());
+    ChangeFeed& feed = ChangeFeed::getInstance();
+    subscription = feed.subscribe(feed.nextSeq(), [this](const ChangeEvent& event) {
+        applyChange(event);
+    });
+}
+
+
+LookupCache::~LookupCache() {
+    ChangeFeed::getInstance().unsubscribe(subscription);
+}
+
+
+LookupCache::Lookup LookupCache::get(int id, Task& task) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = index.find(id);
+    if (it == index.end()) {
+        counters.misses++;
+        return Lookup::Miss;
+    }
+    Slot& slot = slots[it->second];
+    if (Clock::now() >= slot.expires) {
+        // 过期：释放槽位，按未命中处理
+        slot = Slot();
+        index.erase(it);
+        counters.expirations++;
+        counters.misses++;
+        return Lookup::Miss;
+    }
+    slot.referenced = true;
+    if (!slot.present) {
+        counters.negativeHits++;
+        return Lookup::Absent;
+    }
+    counters.hits++;
+    task = slot.task;
+    return Lookup::Present;
+}
+
+
+uint64_t LookupCache::generation() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return gen;
+}
+
+
+void LookupCache::fillPresent(const Task& task, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (generation == gen) {
+        store(task.id, true, &task);
+    }
+}
+
+
+void LookupCache::fillAbsent(int id, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (generation == gen) {
+        store(id, false, nullptr);
+    }
+}
+
+
+LookupCache::Stats LookupCache::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    Stats result = counters;
+    result.size = index.size();
+    result.capacity = slots.size();
+    return result;
+}
+
+
+void LookupCache::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto& slot : slots) {
+        slot = Slot();
+    }
+    index.clear();
+    hand = 0;
+    gen++;
+}
+
+
+void LookupCache::applyChange(const ChangeEvent& event) {
+    if (event.type == ChangeType::Reindex) {
+        clear(); // 所有ID都可能已变化
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    gen++;
+    if (event.type == ChangeType::Delete) {
+        store(event.task.id, false, nullptr);
+    } else {
+        store(event.task.id, true, &event.task);
+    }
+}
+
+
+void LookupCache::store(int id, bool present, const Task* task) {
+    size_t pos;
+    auto it = index.find(id);
+    if (it != index.end()) {
+        pos = it->second;
+    } else {
+        // CLOCK：跳过最近被访问过的槽位（清除其访问位），淘汰第一个未被访问的槽位
+        while (slots[hand].used && slots[hand].referenced) {
+            slots[hand].referenced = false;
+            hand = (hand + 1) % slots.size();
+        }
+        pos = hand;
+        hand = (hand + 1) % slots.size();
+        if (slots[pos].used) {
+            index.erase(slots[pos].id);
+            counters.evictions++;
+        }
+        index[id] = pos;
+    }
+
+    Slot& slot = slots[pos];
+    slot.id = id;
+    slot.used = true;
+    slot.referenced = true;
+    slot.present = present;
+    slot.expires = Clock::now() + (present ? ttl : negativeTtl);
+    slot.task = present ? *task : Task{};
+}
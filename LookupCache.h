@@ -0,0 +1,93 @@
+﻿//LookupCache.h
+#ifndef LOOKUPCACHE_H
+#define LOOKUPCACHE_H
+
+
+#include "Task.h"
+#include "ChangeFeed.h"
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+// 按任务ID的点查询缓存，同时缓存存在的完整行和已知不存在的ID（负缓存）
+// 容量固定，使用 CLOCK 算法淘汰
+// 通过订阅 ChangeFeed 与本进程的所有写路径保持一致：新增/更新写入新行，删除写入负缓存，ID重整时清空
+// 其他进程（另一个 LogSystem、ShardRebalance）的写入不会出现在变更流中，因此每项都有存活时间，
+// 负缓存的存活时间更短，过期后重新查询数据库
+class LookupCache {
+public:
+    enum class Lookup {
+        Miss,    // 未缓存，需要查询数据库
+        Present, // 存在，task 已填充
+        Absent   // 已知不存在
+    };
+
+    struct Stats {
+        uint64_t hits = 0;         // 命中存在的行
+        uint64_t negativeHits = 0; // 命中负缓存
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;  // 因过期被丢弃（计入未命中）
+        size_t size = 0;
+        size_t capacity = 0;
+
+        double hitRate() const {
+            uint64_t total = hits + negativeHits + misses;
+            return total ? static_cast<double>(hits + negativeHits) / total : 0.0;
+        }
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    static const size_t DEFAULT_CAPACITY = 4096;
+    static constexpr std::chrono::milliseconds DEFAULT_TTL{30000};
+    static constexpr std::chrono::milliseconds DEFAULT_NEGATIVE_TTL{5000};
+
+    explicit LookupCache(size_t capacity = DEFAULT_CAPACITY,
+                         std::chrono::milliseconds ttl = DEFAULT_TTL,
+                         std::chrono::milliseconds negativeTtl = DEFAULT_NEGATIVE_TTL);
+    ~LookupCache();
+
+    LookupCache(const LookupCache&) = delete;
+    LookupCache& operator=(const LookupCache&) = delete;
+
+    Lookup get(int id, Task& task);
+
+    // 读穿填充：先取 generation()，查询数据库后用同一个值填充；
+    // 期间若有任何写入被应用，填充会被丢弃，避免旧数据覆盖新数据
+    uint64_t generation() const;
+    void fillPresent(const Task& task, uint64_t generation);
+    void fillAbsent(int id, uint64_t generation);
+
+    Stats stats() const;
+    void clear();
+
+private:
+    struct Slot {
+        int id = 0;
+        bool used = false;
+        bool referenced = false;
+        bool present = false;
+        Clock::time_point expires;
+        Task task{};
+    };
+
+    void applyChange(const ChangeEvent& event);
+    void store(int id, bool present, const Task* task);
+
+    mutable std::mutex mtx;
+    std::vector<Slot> slots;
+    std::unordered_map<int, size_t> index;
+    size_t hand = 0;
+    std::chrono::milliseconds ttl;
+    std::chrono::milliseconds negativeTtl;
+    uint64_t gen = 0;
+    Stats counters;
+    int subscription = 0;
+};
+
+
+#endif // LOOKUPCACHE_H
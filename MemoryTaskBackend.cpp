@@ -0,0 +1,99 @@
+﻿//MemoryTaskBackend.cpp
+#include "MemoryTaskBackend.h"
+#include <algorithm>
+
+
+void MemoryTaskBackend::insert(const Task& task) {
+    std::lock_guard<std::mutex> lock(mtx);
+    tasks[task.id] = task;
+}
+
+
+bool MemoryTaskBackend::fetch(int id, Task& task) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = tasks.find(id);
+    if (it == tasks.end()) {
+        return false;
+    }
+    task = it->second;
+    return true;
+}
+
+
+bool MemoryTaskBackend::update(const Task& task) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = tasks.find(task.id);
+    if (it == tasks.end()) {
+        return false;
+    }
+    it->second.title = task.title;
+    it->second.description = task.description;
+    it->second.priority = task.priority;
+    it->second.dueDate = task.dueDate;
+    return true;
+}
+
+
+bool MemoryTaskBackend::updateStatus(int id, const std::string& status) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = tasks.find(id);
+    if (it == tasks.end()) {
+        return false;
+    }
+    it->second.status = status;
+    return true;
+}
+
+
+bool MemoryTaskBackend::remove(int id) {
+    std::lock_guard<std::mutex> lock(mtx);
+    return tasks.erase(id) > 0;
+}
+
+
+std::vector<Task> MemoryTaskBackend::scan(int sortOption, const std::string& status) {
+    std::vector<Task> result;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        result.reserve(tasks.size());
+        for (const auto& entry : tasks) {
+            if (status.empty() || entry.second.status == status) {
+                result.push_back(entry.second);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end(), [sortOption](const Task& a, const Task& b) {
+        return taskLess(a, b, sortOption);
+    });
+    return result;
+}
+
+
+int MemoryTaskBackend::maxId() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return tasks.empty() ? 0 : tasks.rbegin()->first;
+}
+
+
+void MemoryTaskBackend::seedIds(int maxId) {
+    std::lock_guard<std::mutex> lock(mtx);
+    nextId = std::max(nextId, maxId + 1);
+}
+
+
+int MemoryTaskBackend::allocateId() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return nextId++;
+}
+
+
+int MemoryTaskBackend::storedShardCount() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return shardCount;
+}
+
+
+void MemoryTaskBackend::storeShardCount(int count) {
+    std::lock_guard<std::mutex> lock(mtx);
+    shardCount = count;
+}
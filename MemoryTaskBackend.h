@@ -0,0 +1,34 @@
+﻿//MemoryTaskBackend.h
+#ifndef MEMORYTASKBACKEND_H
+#define MEMORYTASKBACKEND_H
+
+
+#include "ShardedTaskStore.h"
+#include <map>
+#include <mutex>
+
+
+// 进程内的替身后端，不依赖 MySQL，用于 bench_shard 校验归并和再平衡，以及无数据库环境
+class MemoryTaskBackend : public TaskBackend {
+public:
+    void insert(const Task& task) override;
+    bool fetch(int id, Task& task) override;
+    bool update(const Task& task) override;
+    bool updateStatus(int id, const std::string& status) override;
+    bool remove(int id) override;
+    std::vector<Task> scan(int sortOption, const std::string& status) override;
+    int maxId() override;
+    void seedIds(int maxId) override;
+    int allocateId() override;
+    int storedShardCount() override;
+    void storeShardCount(int count) override;
+
+private:
+    std::mutex mtx;
+    std::map<int, Task> tasks;
+    int nextId = 1;
+    int shardCount = 0;
+};
+
+
+#endif // MEMORYTASKBACKEND_H
@@ -0,0 +1,209 @@
+﻿//MySqlTaskBackend.cpp
+#include "MySqlTaskBackend.h"
+#include "DatabaseConfig.h"
+#include "Logger.h"
+#include "TaskRows.h"
+#include <stdexcept>
+#include <cppconn/driver.h>
+#include <cppconn/exception.h>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/statement.h>
+
+
+namespace {
+
+const int ER_NO_SUCH_TABLE = 1146;
+
+const char* orderByClause(int sortOption) {
+    switch (sortOption) {
+        case 1: return " ORDER BY priority, task_id";
+        case 2: return " ORDER BY due_date, task_id";
+        default: return " ORDER BY task_id";
+    }
+}
+
+} // namespace
+
+
+MySqlTaskBackend::MySqlTaskBackend(const std::string& url, const std::string& schema, bool createSchema) {
+    sql::Driver* driver = get_driver_instance();
+    connection.reset(driver->connect(url, DB_USER, DB_PASSWORD));
+    if (!createSchema && useExistingSchema(*connection, schema)) {
+        return;
+    }
+    std::unique_ptr<sql::Statement> stmt(connection->createStatement());
+    stmt->execute("CREATE DATABASE IF NOT EXISTS " + schema);
+    connection->setSchema(schema);
+    stmt->execute(TASKS_TABLE_DDL);
+}
+
+
+MySqlTaskBackend::~MySqlTaskBackend() {
+    if (connection) {
+        connection->close();
+    }
+}
+
+
+std::string MySqlTaskBackend::schemaFor(size_t index) {
+    if (index == 0) {
+        return DB_SCHEMA;
+    }
+    return std::string(DB_SCHEMA) + "_shard" + std::to_string(index);
+}
+
+
+void MySqlTaskBackend::insert(const Task& task) {
+    std::unique_ptr<sql::PreparedStatement> stmt(connection->prepareStatement(
+        "INSERT INTO tasks (task_id, title, description, priority, due_date, status) "
+        "VALUES (?, ?, ?, ?, NULLIF(?, ''), ?) "
+        "ON DUPLICATE KEY UPDATE title = VALUES(title), description = VALUES(description), "
+        "priority = VALUES(priority), due_date = VALUES(due_date), status = VALUES(status)"));
+    stmt->setInt(1, task.id);
+    stmt->setString(2, task.title);
+    stmt->setString(3, task.description);
+    stmt->setInt(4, task.priority);
+    stmt->setString(5, task.dueDate);
+    stmt->setString(6, task.status.empty() ? "pending" : task.status);
+    stmt->executeUpdate();
+}
+
+
+bool MySqlTaskBackend::fetch(int id, Task& task) {
+    std::unique_ptr<sql::PreparedStatement> stmt(connection->prepareStatement(
+        "SELECT task_id, title, description, priority, due_date, status FROM tasks WHERE task_id = ?"));
+    stmt->setInt(1, id);
+    std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
+    if (!res->next()) {
+        return false;
+    }
+    readTaskRow(*res, task);
+    return true;
+}
+
+
+bool MySqlTaskBackend::update(const Task& task) {
+    std::unique_ptr<sql::PreparedStatement> stmt(connection->prepareStatement(
+        "UPDATE tasks SET title = ?, description = ?, priority = ?, due_date = NULLIF(?, ''), "
+        "updated_at=CURRENT_TIMESTAMP WHERE task_id = ?"));
+    stmt->setString(1, task.title);
+    stmt->setString(2, task.description);
+    stmt->setInt(3, task.priority);
+    stmt->setString(4, task.dueDate);
+    stmt->setInt(5, task.id);
+    return stmt->executeUpdate() > 0;
+}
+
+
+bool MySqlTaskBackend::updateStatus(int id, const std::string& status) {
+    // 先确认存在：状态未变化时 UPDATE 的影响行数为0
+    Task existing;
+    if (!fetch(id, existing)) {
+        return false;
+    }
+    std::unique_ptr<sql::PreparedStatement> stmt(connection->prepareStatement(
+        "UPDATE tasks SET status = ? WHERE task_id = ?"));
+    stmt->setString(1, status);
+    stmt->setInt(2, id);
+    stmt->executeUpdate();
+    return true;
+}
+
+
+bool MySqlTaskBackend::remove(int id) {
+    std::unique_ptr<sql::PreparedStatement> stmt(connection->prepareStatement(
+        "DELETE FROM tasks WHERE task_id = ?"));
+    stmt->setInt(1, id);
+    return stmt->executeUpdate() > 0;
+}
+
+
+std::vector<Task> MySqlTaskBackend::scan(int sortOption, const std::string& status) {
+    std::string query = "SELECT task_id, title, description, priority, due_date, status FROM tasks";
+    if (!status.empty()) {
+        query += " WHERE status = ?";
+    }
+    query += orderByClause(sortOption);
+
+    std::unique_ptr<sql::PreparedStatement> stmt(connection->prepareStatement(query));
+    if (!status.empty()) {
+        stmt->setString(1, status);
+    }
+    std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
+
+    return TaskRows(std::move(stmt), std::move(res)).materialize();
+}
+
+
+int MySqlTaskBackend::maxId() {
+    std::unique_ptr<sql::Statement> stmt(connection->createStatement());
+    std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT COALESCE(MAX(task_id), 0) FROM tasks"));
+    return res->next() ? res->getInt(1) : 0;
+}
+
+
+void MySqlTaskBackend::seedIds(int maxId) {
+    std::unique_ptr<sql::Statement> stmt(connection->createStatement());
+    stmt->execute("CREATE TABLE IF NOT EXISTS task_id_seq (id INT PRIMARY KEY, next_id INT NOT NULL)");
+    std::unique_ptr<sql::PreparedStatement> seed(connection->prepareStatement(
+        "INSERT INTO task_id_seq (id, next_id) VALUES (1, ?) "
+        "ON DUPLICATE KEY UPDATE next_id = GREATEST(next_id, VALUES(next_id))"));
+    seed->setInt(1, maxId + 1);
+    seed->executeUpdate();
+}
+
+
+int MySqlTaskBackend::allocateId() {
+    // LAST_INSERT_ID(expr) 使自增在多个连接和进程之间保持原子
+    std::unique_ptr<sql::Statement> stmt(connection->createStatement());
+    stmt->executeUpdate("UPDATE task_id_seq SET next_id = LAST_INSERT_ID(next_id + 1) WHERE id = 1");
+    std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT LAST_INSERT_ID()"));
+    if (!res->next()) {
+        throw std::runtime_error("分配任务ID失败");
+    }
+    return res->getInt(1) - 1;
+}
+
+
+int MySqlTaskBackend::storedShardCount() {
+    return readShardCount(*connection);
+}
+
+
+void MySqlTaskBackend::storeShardCount(int count) {
+    std::unique_ptr<sql::Statement> stmt(connection->createStatement());
+    stmt->execute("CREATE TABLE IF NOT EXISTS shard_config (id INT PRIMARY KEY, shard_count INT NOT NULL)");
+    std::unique_ptr<sql::PreparedStatement> store(connection->prepareStatement(
+        "INSERT INTO shard_config (id, shard_count) VALUES (1, ?) "
+        "ON DUPLICATE KEY UPDATE shard_count = VALUES(shard_count)"));
+    store->setInt(1, count);
+    store->executeUpdate();
+}
+
+
+bool useExistingSchema(sql::Connection& connection, const std::string& schema) {
+    try {
+        connection.setSchema(schema);
+        std::unique_ptr<sql::Statement> stmt(connection.createStatement());
+        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT 1 FROM tasks LIMIT 0"));
+        return true;
+    } catch (sql::SQLException& e) {
+        Logger::getInstance().log("schema 版本缓存失效 (" + schema + "): " + std::string(e.what()));
+        return false;
+    }
+}
+
+
+int readShardCount(sql::Connection& connection) {
+    try {
+        std::unique_ptr<sql::Statement> stmt(connection.createStatement());
+        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT shard_count FROM shard_config WHERE id = 1"));
+        return res->next() ? res->getInt(1) : 0;
+    } catch (sql::SQLException& e) {
+        if (e.getErrorCode() == ER_NO_SUCH_TABLE) {
+            return 0; // 从未启用过分片
+        }
+        throw;
+    }
+}
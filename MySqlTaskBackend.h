@@ -0,0 +1,49 @@
+﻿//MySqlTaskBackend.h
+#ifndef MYSQLTASKBACKEND_H
+#define MYSQLTASKBACKEND_H
+
+
+#include "ShardedTaskStore.h"
+#include <memory>
+#include <string>
+#include <cppconn/connection.h>
+
+
+// MySQL 后端：每个分片是同一实例（或本地其他实例）上的独立 schema
+class MySqlTaskBackend : public TaskBackend {
+public:
+    // 连接并在需要时创建 schema 和任务表，失败时抛出 sql::SQLException
+    // createSchema 为 false 时先直接切换到 schema，只有库或任务表不存在时才执行DDL
+    MySqlTaskBackend(const std::string& url, const std::string& schema, bool createSchema = true);
+    ~MySqlTaskBackend() override;
+
+    // 第 index 个分片的 schema 名称，0号分片即原有的单库
+    static std::string schemaFor(size_t index);
+
+    void insert(const Task& task) override;
+    bool fetch(int id, Task& task) override;
+    bool update(const Task& task) override;
+    bool updateStatus(int id, const std::string& status) override;
+    bool remove(int id) override;
+    std::vector<Task> scan(int sortOption, const std::string& status) override;
+    int maxId() override;
+    void seedIds(int maxId) override;
+    int allocateId() override;
+    int storedShardCount() override;
+    void storeShardCount(int count) override;
+
+private:
+    std::unique_ptr<sql::Connection> connection;
+};
+
+
+// schema 版本缓存命中时使用：切换到 schema 并确认任务表存在（一次轻量查询代替DDL）
+// 库或表已被删除时返回false，调用方应重新执行DDL
+bool useExistingSchema(sql::Connection& connection, const std::string& schema);
+
+// 读取 schema 中记录的分片数（shard_config 表），未记录时返回0
+// 单库模式也用它检查数据是否已经按多个分片存放
+int readShardCount(sql::Connection& connection);
+
+
+#endif // MYSQLTASKBACKEND_H
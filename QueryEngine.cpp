@@ -0,0 +1,165 @@
+﻿//QueryEngine.cpp
+#include "QueryEngine.h"
+#include <algorithm>
+#include <ctime>
+#include <map>
+#include <mutex>
+
+
+void TaskReport::merge(const TaskReport& other) {
+    total += other.total;
+    overdue += other.overdue;
+    for (int s = 0; s < TASK_STATUS_COUNT; ++s) {
+        byStatus[s] += other.byStatus[s];
+    }
+    for (size_t p = 0; p < byPriority.size(); ++p) {
+        for (int s = 0; s < TASK_STATUS_COUNT; ++s) {
+            byPriority[p][s] += other.byPriority[p][s];
+        }
+        overdueByPriority[p] += other.overdueByPriority[p];
+    }
+}
+
+
+int32_t QueryEngine::today() {
+    std::time_t now = std::time(nullptr);
+    std::tm local = *std::localtime(&now);
+    char buf[16];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d", &local);
+    return parseDueDate(buf);
+}
+
+
+TaskReport QueryEngine::aggregate(const TaskStore& store, int32_t today) const {
+    TaskReport result;
+    std::mutex resultMtx;
+    const uint8_t* priorities = store.priorityColumn().data();
+    const TaskStatus* statuses = store.statusColumn().data();
+    const int32_t* dueDays = store.dueDayColumn().data();
+
+    pool.parallelFor(store.size(), [&](size_t begin, size_t end) {
+        TaskReport local;
+        local.total = end - begin;
+        for (size_t i = begin; i < end; ++i) {
+            int s = static_cast<int>(statuses[i]);
+            uint8_t p = priorities[i];
+            bool overdue = dueDays[i] != NO_DUE_DATE && dueDays[i] < today &&
+                           statuses[i] != TaskStatus::Completed;
+            local.byStatus[s]++;
+            local.byPriority[p][s]++;
+            local.overdue += overdue;
+            local.overdueByPriority[p] += overdue;
+        }
+        std::lock_guard<std::mutex> lock(resultMtx);
+        result.merge(local);
+    });
+    return result;
+}
+
+
+std::vector<uint32_t> QueryEngine::filterByStatus(const TaskStore& store, TaskStatus status) const {
+    // 各块独立收集后按起始位置拼接，保证结果与串行扫描顺序一致
+    std::map<size_t, std::vector<uint32_t>> parts;
+    std::mutex partsMtx;
+    const TaskStatus* statuses = store.statusColumn().data();
+
+    pool.parallelFor(store.size(), [&](size_t begin, size_t end) {
+        std::vector<uint32_t> rows;
+        for (size_t i = begin; i < end; ++i) {
+            if (statuses[i] == status) {
+                rows.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        std::lock_guard<std::mutex> lock(partsMtx);
+        parts[begin] = std::move(rows);
+    });
+
+    size_t total = 0;
+    for (const auto& part : parts) {
+        total += part.second.size();
+    }
+    std::vector<uint32_t> result;
+    result.reserve(total);
+    for (const auto& part : parts) {
+        result.insert(result.end(), part.second.begin(), part.second.end());
+    }
+    return result;
+}
+
+
+std::vector<uint32_t> QueryEngine::upcoming(const TaskStore& store, size_t limit) const {
+    std::vector<uint64_t> candidates;
+    std::mutex candidatesMtx;
+    const TaskStatus* statuses = store.statusColumn().data();
+    const int32_t* dueDays = store.dueDayColumn().data();
+
+    pool.parallelFor(store.size(), [&](size_t begin, size_t end) {
+        std::vector<uint64_t> keys;
+        for (size_t i = begin; i < end; ++i) {
+            if (statuses[i] != TaskStatus::Completed && dueDays[i] != NO_DUE_DATE) {
+                keys.push_back(store.sortKey(static_cast<uint32_t>(i), 2));
+            }
+        }
+        size_t keep = std::min(limit, keys.size());
+        std::partial_sort(keys.begin(), keys.begin() + keep, keys.end());
+        std::lock_guard<std::mutex> lock(candidatesMtx);
+        candidates.insert(candidates.end(), keys.begin(), keys.begin() + keep);
+    });
+
+    size_t keep = std::min(limit, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end());
+    std::vector<uint32_t> rows(keep);
+    for (size_t i = 0; i < keep; ++i) {
+        rows[i] = store.find(static_cast<int>(static_cast<uint32_t>(candidates[i])));
+    }
+    return rows;
+}
+
+
+std::vector<uint32_t> QueryEngine::sortedRows(const TaskStore& store, int sortOption) const {
+    const size_t n = store.size();
+    std::vector<uint64_t> keys(n);
+    pool.parallelFor(n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            keys[i] = store.sortKey(static_cast<uint32_t>(i), sortOption);
+        }
+    });
+
+    // 每个线程先排序一段，再逐轮两两归并
+    size_t runs = std::max<size_t>(1, std::min(pool.size(), n / 16384));
+    size_t runSize = (n + runs - 1) / std::max<size_t>(runs, 1);
+    if (runSize == 0) {
+        runSize = 1;
+    }
+    pool.parallelFor(runs, [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            size_t lo = std::min(r * runSize, n);
+            size_t hi = std::min(lo + runSize, n);
+            std::sort(keys.begin() + lo, keys.begin() + hi);
+        }
+    }, 1);
+
+    std::vector<uint64_t> buffer(n);
+    for (size_t width = runSize; width < n; width *= 2) {
+        size_t pairs = (n + 2 * width - 1) / (2 * width);
+        pool.parallelFor(pairs, [&](size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p) {
+                size_t lo = p * 2 * width;
+                size_t mid = std::min(lo + width, n);
+                size_t hi = std::min(lo + 2 * width, n);
+                std::merge(keys.begin() + lo, keys.begin() + mid,
+                           keys.begin() + mid, keys.begin() + hi,
+                           buffer.begin() + lo);
+            }
+        }, 1);
+        keys.swap(buffer);
+    }
+
+    std::vector<uint32_t> rows(n);
+    pool.parallelFor(n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            rows[i] = store.find(static_cast<int>(static_cast<uint32_t>(keys[i])));
+        }
+    });
+    return rows;
+}
@@ -0,0 +1,51 @@
+﻿//QueryEngine.h
+#ifndef QUERYENGINE_H
+#define QUERYENGINE_H
+
+
+#include "TaskStore.h"
+#include "ThreadPool.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+
+// 任务统计报表
+struct TaskReport {
+    size_t total = 0;
+    size_t overdue = 0; // 截止日期早于今天且未完成
+    std::array<size_t, TASK_STATUS_COUNT> byStatus{};
+    // 按优先级（下标为优先级数值）统计各状态数量和逾期数量
+    std::array<std::array<size_t, TASK_STATUS_COUNT>, 256> byPriority{};
+    std::array<size_t, 256> overdueByPriority{};
+
+    void merge(const TaskReport& other);
+};
+
+
+// 基于内存快照的并行查询引擎：过滤、聚合与排序都在 TaskStore 的列上完成，不访问数据库
+class QueryEngine {
+public:
+    explicit QueryEngine(ThreadPool& pool) : pool(pool) {}
+
+    // 今天对应的天数（本地时区）
+    static int32_t today();
+
+    TaskReport aggregate(const TaskStore& store, int32_t today) const;
+
+    // 返回指定状态的行号，保持行号顺序
+    std::vector<uint32_t> filterByStatus(const TaskStore& store, TaskStatus status) const;
+
+    // 并行归并排序，结果与 TaskStore::sortedRows 一致
+    std::vector<uint32_t> sortedRows(const TaskStore& store, int sortOption) const;
+
+    // 截止日期最近的 limit 个未完成且有截止日期的任务行号，顺序与 sortedRows(store, 2) 一致
+    // 每块只保留前 limit 个，不对全部任务排序
+    std::vector<uint32_t> upcoming(const TaskStore& store, size_t limit) const;
+
+private:
+    ThreadPool& pool;
+};
+
+
+#endif // QUERYENGINE_H
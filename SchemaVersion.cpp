@@ -0,0 +1,61 @@
+﻿//SchemaVersion.cpp
+#include "SchemaVersion.h"
+#include "DatabaseConfig.h"
+#include "Logger.h"
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+
+namespace {
+
+std::mutex fileMtx; // 多个连接可能同时初始化
+
+std::map<std::string, int> readVersions() {
+    std::map<std::string, int> versions;
+    std::ifstream in(SCHEMA_VERSION_FILE);
+    std::string schema;
+    int version;
+    while (in >> schema >> version) {
+        versions[schema] = version;
+    }
+    return versions;
+}
+
+} // namespace
+
+
+bool schemaVersionCached(const std::string& schema) {
+    std::lock_guard<std::mutex> lock(fileMtx);
+    std::map<std::string, int> versions = readVersions();
+    auto it = versions.find(schema);
+    return it != versions.end() && it->second == SCHEMA_VERSION;
+}
+
+
+void recordSchemaVersion(const std::string& schema) {
+    std::lock_guard<std::mutex> lock(fileMtx);
+    std::map<std::string, int> versions = readVersions();
+    if (versions[schema] == SCHEMA_VERSION) {
+        return;
+    }
+    versions[schema] = SCHEMA_VERSION;
+
+    // 先写临时文件再改名，避免中途失败留下半个文件
+    std::string tmpPath = std::string(SCHEMA_VERSION_FILE) + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        for (const auto& entry : versions) {
+            out << entry.first << ' ' << entry.second << '\n';
+        }
+        if (!out) {
+            Logger::getInstance().log("写入 schema 版本缓存失败");
+            return;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), SCHEMA_VERSION_FILE) != 0) {
+        Logger::getInstance().log("写入 schema 版本缓存失败");
+        std::remove(tmpPath.c_str());
+    }
+}
@@ -0,0 +1,19 @@
+﻿//SchemaVersion.h
+#ifndef SCHEMAVERSION_H
+#define SCHEMAVERSION_H
+
+
+#include <string>
+
+
+// 本地 schema 版本缓存（SCHEMA_VERSION_FILE，每行 "<schema> <版本>"）
+// 某个 schema 记录的版本与 SCHEMA_VERSION 一致时，快速启动可以跳过建库建表的DDL
+// 删除该文件即可强制下次启动重新执行DDL
+
+bool schemaVersionCached(const std::string& schema);
+
+// DDL 成功后记录当前版本
+void recordSchemaVersion(const std::string& schema);
+
+
+#endif // SCHEMAVERSION_H
@@ -0,0 +1,49 @@
+﻿//ShardRebalance.cpp
+// 分片再平衡工具：修改分片数后把任务迁移到新的哈希归属
+// 用法: ShardRebalance <当前分片数> <新分片数>
+// 运行期间请停止其他 LogSystem 进程，避免迁移时有新的写入
+// <当前分片数> 必须与0号分片上记录的一致；迁移完成后记录的分片数更新为 <新分片数>
+#include "DatabaseConfig.h"
+#include "Logger.h"
+#include "MySqlTaskBackend.h"
+#include <cppconn/exception.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cout << "用法: ShardRebalance <当前分片数> <新分片数>" << std::endl;
+        return 1;
+    }
+    int oldCount = std::atoi(argv[1]);
+    int newCount = std::atoi(argv[2]);
+    if (oldCount < 1 || newCount < 1) {
+        std::cout << "分片数必须大于0。" << std::endl;
+        return 1;
+    }
+
+    auto factory = [](size_t index) -> std::unique_ptr<TaskBackend> {
+        return std::make_unique<MySqlTaskBackend>(DB_URL, MySqlTaskBackend::schemaFor(index));
+    };
+
+    try {
+        std::vector<std::unique_ptr<TaskBackend>> backends;
+        for (int i = 0; i < oldCount; ++i) {
+            backends.push_back(factory(i));
+        }
+        ShardedTaskStore store(std::move(backends));
+        size_t moved = store.rebalance(newCount, factory);
+        std::cout << "再平衡完成: " << oldCount << " -> " << newCount
+                  << " 个分片，迁移任务 " << moved << " 个。" << std::endl;
+        if (newCount < oldCount) {
+            std::cout << "编号 " << newCount << " 及以上的分片库已清空，可以手动删除。" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "再平衡失败: " << e.what() << std::endl;
+        Logger::getInstance().log("分片再平衡失败: " + std::string(e.what()));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,224 @@
+﻿//ShardedTaskStore.cpp
+#include "ShardedTaskStore.h"
+#include "Logger.h"
+#include <algorithm>
+#include <future>
+#include <queue>
+#include <stdexcept>
+
+
+namespace {
+
+OpResult shardError(const std::string& what, const std::exception& e) {
+    Logger::getInstance().log(what + ": " + std::string(e.what()));
+    return failure(OpStatus::Error, what + ": " + e.what());
+}
+
+} // namespace
+
+
+bool taskLess(const Task& a, const Task& b, int sortOption) {
+    switch (sortOption) {
+        case 1:
+            if (a.priority != b.priority) return a.priority < b.priority;
+            break;
+        case 2:
+            if (a.dueDate != b.dueDate) return a.dueDate < b.dueDate;
+            break;
+        default:
+            break;
+    }
+    return a.id < b.id;
+}
+
+
+ShardedTaskStore::ShardedTaskStore(std::vector<std::unique_ptr<TaskBackend>> backends, bool verifyLayout)
+    : shards(std::move(backends)) {
+    if (shards.empty()) {
+        throw std::invalid_argument("分片数必须大于0");
+    }
+    if (!verifyLayout) {
+        return;
+    }
+    int maxId = 0;
+    bool otherShardsUsed = false; // 0号以外的分片上有数据
+    for (size_t i = 0; i < shards.size(); ++i) {
+        int shardMax = shards[i]->maxId();
+        maxId = std::max(maxId, shardMax);
+        otherShardsUsed = otherShardsUsed || (i > 0 && shardMax > 0);
+    }
+
+    int count = static_cast<int>(shards.size());
+    int stored = shards[0]->storedShardCount();
+    if (stored == 0) {
+        // 未记录分片数：只有0号分片有数据说明是单库数据，不能直接按哈希读写；
+        // 其他分片也有数据则是记录分片数之前创建的分片库，沿用当前分片数
+        if (count > 1 && maxId > 0 && !otherShardsUsed) {
+            throw std::runtime_error("数据库中已有单库数据，请先运行 ShardRebalance 1 " + std::to_string(count));
+        }
+        shards[0]->storeShardCount(count);
+    } else if (stored != count) {
+        throw std::runtime_error("数据按 " + std::to_string(stored) + " 个分片存放，当前分片数为 " +
+                                 std::to_string(count) + "，请使用 --shards=" + std::to_string(stored) +
+                                 " 启动，或先运行 ShardRebalance " + std::to_string(stored) + " " +
+                                 std::to_string(count));
+    }
+    shards[0]->seedIds(maxId);
+}
+
+
+size_t ShardedTaskStore::shardFor(int id, size_t shardCount) {
+    // murmur3 的最终混合步骤，让连续ID均匀分散
+    uint32_t h = static_cast<uint32_t>(id);
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h % shardCount;
+}
+
+
+OpResult ShardedTaskStore::add(const std::string& title, const std::string& description, int priority, const std::string& dueDate) {
+    try {
+        OpResult result;
+        int id = shards[0]->allocateId();
+        TaskBackend& shard = shardOf(id);
+        shard.insert(Task{id, title, description, priority, dueDate, "pending"});
+        // 回读实际存储的行（MySQL 会规范化日期等字段）
+        if (!shard.fetch(id, result.task)) {
+            return notFound(id); // 插入后被并发删除
+        }
+        return result;
+    } catch (const std::exception& e) {
+        return shardError("添加任务失败", e);
+    }
+}
+
+
+OpResult ShardedTaskStore::update(int id, const std::string& title, const std::string& description, int priority, const std::string& dueDate) {
+    try {
+        TaskBackend& shard = shardOf(id);
+        if (!shard.update(Task{id, title, description, priority, dueDate, ""})) {
+            return notFound(id);
+        }
+        OpResult result;
+        if (!shard.fetch(id, result.task)) {
+            return notFound(id); // 更新后被并发删除
+        }
+        return result;
+    } catch (const std::exception& e) {
+        return shardError("更新任务失败", e);
+    }
+}
+
+
+OpResult ShardedTaskStore::updateStatus(int id, const std::string& status) {
+    try {
+        TaskBackend& shard = shardOf(id);
+        if (!shard.updateStatus(id, status)) {
+            return notFound(id);
+        }
+        OpResult result;
+        if (!shard.fetch(id, result.task)) {
+            return notFound(id); // 更新后被并发删除
+        }
+        return result;
+    } catch (const std::exception& e) {
+        return shardError("更新任务状态失败", e);
+    }
+}
+
+
+OpResult ShardedTaskStore::remove(int id) {
+    try {
+        if (!shardOf(id).remove(id)) {
+            return notFound(id);
+        }
+        OpResult result;
+        result.task.id = id;
+        return result;
+    } catch (const std::exception& e) {
+        return shardError("删除任务失败", e);
+    }
+}
+
+
+bool ShardedTaskStore::fetch(int id, Task& task) {
+    return shardOf(id).fetch(id, task);
+}
+
+
+std::vector<Task> ShardedTaskStore::list(int sortOption, const std::string& status) {
+    // 分散：每个分片在自己的连接上并行查询
+    std::vector<std::future<std::vector<Task>>> pending;
+    pending.reserve(shards.size());
+    for (auto& shard : shards) {
+        TaskBackend* backend = shard.get();
+        pending.push_back(std::async(std::launch::async, [backend, sortOption, status] {
+            return backend->scan(sortOption, status);
+        }));
+    }
+    std::vector<std::vector<Task>> parts;
+    parts.reserve(pending.size());
+    size_t total = 0;
+    for (auto& f : pending) {
+        parts.push_back(f.get());
+        total += parts.back().size();
+    }
+
+    // 归并：各分片结果已有序，用小顶堆做k路归并
+    using Cursor = std::pair<size_t, size_t>; // (分片, 位置)
+    auto greater = [&](const Cursor& a, const Cursor& b) {
+        return taskLess(parts[b.first][b.second], parts[a.first][a.second], sortOption);
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(greater)> heap(greater);
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (!parts[i].empty()) {
+            heap.push(Cursor(i, 0));
+        }
+    }
+
+    std::vector<Task> result;
+    result.reserve(total);
+    while (!heap.empty()) {
+        Cursor top = heap.top();
+        heap.pop();
+        result.push_back(std::move(parts[top.first][top.second]));
+        if (top.second + 1 < parts[top.first].size()) {
+            heap.push(Cursor(top.first, top.second + 1));
+        }
+    }
+    return result;
+}
+
+
+size_t ShardedTaskStore::rebalance(size_t newCount, const BackendFactory& factory) {
+    if (newCount == 0) {
+        throw std::invalid_argument("分片数必须大于0");
+    }
+    size_t oldCount = shards.size();
+    for (size_t i = oldCount; i < newCount; ++i) {
+        shards.push_back(factory(i));
+    }
+
+    size_t moved = 0;
+    for (size_t i = 0; i < oldCount; ++i) {
+        for (const Task& task : shards[i]->scan(0, "")) {
+            size_t target = shardFor(task.id, newCount);
+            if (target == i) {
+                continue;
+            }
+            shards[target]->insert(task);
+            shards[i]->remove(task.id);
+            ++moved;
+        }
+    }
+    // 缩容时多余的分片已经清空
+    shards.resize(newCount);
+    shards[0]->storeShardCount(static_cast<int>(newCount));
+
+    Logger::getInstance().log("分片再平衡完成: " + std::to_string(oldCount) + " -> " +
+                              std::to_string(newCount) + "，迁移任务数: " + std::to_string(moved));
+    return moved;
+}
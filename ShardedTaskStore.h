@@ -0,0 +1,80 @@
+﻿//ShardedTaskStore.h
+#ifndef SHARDEDTASKSTORE_H
+#define SHARDEDTASKSTORE_H
+
+
+#include "Task.h"
+#include "TaskResult.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+// 单个分片的存储后端
+class TaskBackend {
+public:
+    virtual ~TaskBackend() = default;
+
+    // 按给定ID写入任务，ID已存在时覆盖（再平衡中断后重跑时可能出现）
+    virtual void insert(const Task& task) = 0;
+    virtual bool fetch(int id, Task& task) = 0;
+    // 覆盖标题、描述、优先级和截止日期
+    virtual bool update(const Task& task) = 0;
+    virtual bool updateStatus(int id, const std::string& status) = 0;
+    virtual bool remove(int id) = 0;
+    // 按排序选项返回任务（0-按ID, 1-按优先级, 2-按截止日期，后两者以ID为次序键），status 为空表示不过滤
+    virtual std::vector<Task> scan(int sortOption, const std::string& status) = 0;
+    virtual int maxId() = 0;
+
+    // 全局ID序列，只在0号分片上使用
+    virtual void seedIds(int maxId) = 0;
+    virtual int allocateId() = 0;
+
+    // 数据当前所按的分片数，记录在0号分片上，未记录时返回0
+    virtual int storedShardCount() = 0;
+    virtual void storeShardCount(int count) = 0;
+};
+
+
+// 与 MySQL 端 ORDER BY <字段>, task_id 一致的比较（空截止日期即 NULL，排在最前）
+// 各后端的 scan 必须按此顺序返回，list 的k路归并依赖它
+bool taskLess(const Task& a, const Task& b, int sortOption);
+
+
+// 按ID哈希把任务分布到多个后端
+// 点操作直接路由到所属分片；列表查询并行扫描所有分片后做k路归并，保持三种排序
+// 分片模式下删除不再重整ID（跨分片重编号代价过高），ID由0号分片上的序列统一分配
+class ShardedTaskStore {
+public:
+    using BackendFactory = std::function<std::unique_ptr<TaskBackend>(size_t index)>;
+
+    // 分片数必须与0号分片上记录的一致（首次使用且库为空时记录下来），否则抛出 std::runtime_error，
+    // 避免按错误的哈希归属读写；verifyLayout 为 false 时跳过检查和ID序列初始化（同组的其他连接已完成）
+    explicit ShardedTaskStore(std::vector<std::unique_ptr<TaskBackend>> backends, bool verifyLayout = true);
+
+    size_t shardCount() const { return shards.size(); }
+    static size_t shardFor(int id, size_t shardCount);
+
+    OpResult add(const std::string& title, const std::string& description, int priority, const std::string& dueDate);
+    OpResult update(int id, const std::string& title, const std::string& description, int priority, const std::string& dueDate);
+    OpResult updateStatus(int id, const std::string& status);
+    OpResult remove(int id);
+    bool fetch(int id, Task& task);
+
+    // 分散查询所有分片并归并，status 为空表示不过滤
+    std::vector<Task> list(int sortOption, const std::string& status = "");
+
+    // 把分片数调整为 newCount，迁移哈希归属发生变化的任务，返回迁移的任务数
+    // 先写入目标分片再从原分片删除，全部完成后才更新记录的分片数，中断后可以安全重跑；迁移期间不应有其他写入
+    size_t rebalance(size_t newCount, const BackendFactory& factory);
+
+private:
+    TaskBackend& shardOf(int id) { return *shards[shardFor(id, shards.size())]; }
+
+    std::vector<std::unique_ptr<TaskBackend>> shards;
+};
+
+
+#endif // SHARDEDTASKSTORE_H
@@ -102,8 +102,8 @@ public:
         return str + std::string(targetWidth - currentWidth, ' ');
     }
     // 输出表头
-    static void printHeader() {
-        std::cout << std::left 
+    static void printHeader(std::ostream& out = std::cout) {
+        out << std::left 
                   << padToWidth("ID", ID_WIDTH) << " | "
                   << padToWidth("标题", TITLE_WIDTH) << " | "
                   << padToWidth("优先级", PRIORITY_WIDTH) << " | "
@@ -115,7 +115,7 @@ public:
         // 计算分隔线长度
         int totalWidth = ID_WIDTH + TITLE_WIDTH + PRIORITY_WIDTH + 
                         DUEDATE_WIDTH + STATUS_WIDTH + DESCRIPTION_WIDTH +10;
-        std::cout << std::string(totalWidth, '-') << std::endl;
+        out << std::string(totalWidth, '-') << std::endl;
     }
     
     // 输出任务行（用于Task结构体）
@@ -1,13 +1,48 @@
 ﻿//TaskManager.cpp
 #include "TaskManager.h"
 #include "Logger.h"
+#include "ChangeFeed.h"
+#include "DatabaseConfig.h"
+#include "MySqlTaskBackend.h"
+#include "SchemaVersion.h"
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
-#include "TableFormatter.h"
 
-TaskManager::TaskManager() {
-    establishConnection();
-    initializeDatabase();
+TaskManager::TaskManager(size_t shardCount, std::shared_ptr<LookupCache> lookupCache, bool fastStart, bool schemaReady)
+    : cache(lookupCache ? std::move(lookupCache) : std::make_shared<LookupCache>()),
+      requestedShards(std::max<size_t>(shardCount, 1)), fastStart(fastStart), schemaReady(schemaReady) {
+    if (fastStart || schemaReady) {
+        return; // 首次使用时再连接
+    }
+    try {
+        ensureConnected();
+    } catch (sql::SQLException& e) {
+        throw std::runtime_error("数据库连接失败: " + std::string(e.what()));
+    }
+}
+
+void TaskManager::ensureConnected() const {
+    if (connected) {
+        return;
+    }
+    if (!connection) {
+        establishConnection();
+        std::string error;
+        if (!initializeDatabase(error)) {
+            // 丢弃未初始化完成的连接，下次使用时重新连接并初始化
+            connection.reset();
+            throw sql::SQLException("数据库初始化失败: " + error);
+        }
+    }
+    if (requestedShards > 1) {
+        if (!shards) {
+            openShards(requestedShards);
+        }
+    } else if (!schemaReady) {
+        checkSingleLayout();
+    }
+    connected = true;
     Logger::getInstance().log("数据库连接已建立。");
 }
 
@@ -18,52 +53,111 @@ TaskManager::~TaskManager() {
     }
 }
 
-void TaskManager::establishConnection() {
+void TaskManager::establishConnection() const {
     try {
         sql::Driver* driver = get_driver_instance();
-        // 修改为你的数据库连接信息
-        connection.reset(driver->connect("tcp://127.0.0.1:3306", "taskuser", "12345"));
-        connection->setSchema("task_manager"); // 使用我们创建的数据库
+        connection.reset(driver->connect(DB_URL, DB_USER, DB_PASSWORD));
         Logger::getInstance().log("MySQL数据库连接成功建立");
     } catch (sql::SQLException& e) {
-        std::cerr << "MySQL数据库连接失败: " << e.what() << std::endl;
+        connection.reset();
         Logger::getInstance().log("MySQL数据库连接失败: " + std::string(e.what()));
-        throw std::runtime_error("数据库连接失败");
+        throw; // 由调用方转换为操作失败并输出，这里只记录日志
+    }
+}
+
+void TaskManager::openShards(size_t shardCount) const {
+    try {
+        std::vector<std::unique_ptr<TaskBackend>> backends;
+        for (size_t i = 0; i < shardCount; ++i) {
+            std::string schema = MySqlTaskBackend::schemaFor(i);
+            bool createSchema = !schemaReady && !(fastStart && schemaVersionCached(schema));
+            backends.push_back(std::make_unique<MySqlTaskBackend>(DB_URL, schema, createSchema));
+            if (createSchema) {
+                recordSchemaVersion(schema);
+            }
+        }
+        shards = std::make_unique<ShardedTaskStore>(std::move(backends), !schemaReady);
+        Logger::getInstance().log("分片模式已启用，分片数: " + std::to_string(shardCount));
+    } catch (sql::SQLException& e) {
+        Logger::getInstance().log("分片连接失败: " + std::string(e.what()));
+        throw;
+    } catch (const std::runtime_error& e) {
+        // 分片数与库中记录的不一致，按数据库错误交给调用方
+        Logger::getInstance().log("分片配置错误: " + std::string(e.what()));
+        throw sql::SQLException(e.what());
     }
 }
 
-void TaskManager::initializeDatabase() {
+void TaskManager::checkSingleLayout() const {
+    int stored = readShardCount(*connection);
+    if (stored > 1) {
+        std::string message = "数据按 " + std::to_string(stored) + " 个分片存放，请使用 --shards=" +
+                              std::to_string(stored) + " 启动，或先运行 ShardRebalance " +
+                              std::to_string(stored) + " 1";
+        Logger::getInstance().log("分片配置错误: " + message);
+        throw sql::SQLException(message);
+    }
+}
+
+bool TaskManager::initializeDatabase(std::string& error) const {
+    // 已初始化或版本一致时跳过DDL；库或表已被删除时继续执行DDL重新创建
+    bool skipDdl = schemaReady || (fastStart && schemaVersionCached(DB_SCHEMA));
+    if (skipDdl && useExistingSchema(*connection, DB_SCHEMA)) {
+        return true;
+    }
     try {
         std::unique_ptr<sql::Statement> stmt(connection->createStatement());
         
         // 创建数据库（如果不存在）
-        stmt->execute("CREATE DATABASE IF NOT EXISTS task_manager");
-        connection->setSchema("task_manager");
+        stmt->execute("CREATE DATABASE IF NOT EXISTS " + std::string(DB_SCHEMA));
+        connection->setSchema(DB_SCHEMA);
         
         // 创建任务表
-        stmt->execute(
-            "CREATE TABLE IF NOT EXISTS tasks ("
-            "task_id INT AUTO_INCREMENT PRIMARY KEY, "
-            "title VARCHAR(255) NOT NULL DEFAULT 'Task', "
-            "description TEXT, "
-            "status ENUM('pending', 'in_progress', 'completed') DEFAULT 'pending', "
-            "priority INT DEFAULT 2 COMMENT '1-高, 2-中, 3-低', "
-            "due_date DATE, "
-            "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP, "
-            "updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP"
-            ")"
-        );
+        stmt->execute(TASKS_TABLE_DDL);
+        recordSchemaVersion(DB_SCHEMA);
         
         Logger::getInstance().log("数据库初始化完成");
+        return true;
     } catch (sql::SQLException& e) {
-        std::cerr << "数据库初始化失败: " << e.what() << std::endl;
         Logger::getInstance().log("数据库初始化失败: " + std::string(e.what()));
+        error = e.what();
+        return false;
+    }
+}
+
+namespace {
+
+// 操作成功时发布变更事件
+OpResult published(ChangeType type, const OpResult& result) {
+    if (result.ok()) {
+        ChangeFeed::getInstance().publish(type, result.task);
     }
+    return result;
 }
 
-void TaskManager::addTask(const std::string& title,const std::string& description, int priority, const std::string& dueDate) {
+// 加载快照时跳过无法存入 TaskStore 的行（例如状态值未知），只记录日志
+void loadRow(TaskStore& store, const Task& task) {
+    try {
+        store.upsert(task);
+    } catch (const std::invalid_argument& e) {
+        Logger::getInstance().log("跳过任务 ID " + std::to_string(task.id) + ": " + e.what());
+    }
+}
+
+OpResult dbError(const std::string& what, const sql::SQLException& e) {
+    Logger::getInstance().log(what + ": " + std::string(e.what()));
+    return failure(OpStatus::Error, what + ": " + e.what());
+}
+
+} // namespace
+
+OpResult TaskManager::addTask(const std::string& title,const std::string& description, int priority, const std::string& dueDate) {
      try {
-        std::unique_ptr<sql::PreparedStatement> prepStmt(connection->prepareStatement(
+        if (sharded()) {
+            Logger::getInstance().log("添加任务: " + title);
+            return published(ChangeType::Add, shards->add(title, description, priority, dueDate));
+        }
+        std::unique_ptr<sql::PreparedStatement> prepStmt(db().prepareStatement(
             "INSERT INTO tasks (title, description, priority, due_date) VALUES (?, ?, ?, ?)"));
         
         prepStmt->setString(1, title);
@@ -72,39 +166,64 @@ void TaskManager::addTask(const std::string& title,const std::string& descriptio
         prepStmt->setString(4, dueDate);
         prepStmt->executeUpdate();
         
+        // 取回自增ID，按ID回读实际存储的行（MySQL 会规范化日期等字段）再发布新增事件
+        OpResult result;
+        std::unique_ptr<sql::Statement> stmt(db().createStatement());
+        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT LAST_INSERT_ID()"));
+        if (res->next() && readTaskFromDb(res->getInt(1), result.task)) {
+            ChangeFeed::getInstance().publish(ChangeType::Add, result.task);
+        }
       
         Logger::getInstance().log("添加任务: " + title);
+        return result;
         
     } catch (sql::SQLException& e) {
-        std::cerr << "添加任务失败: " << e.what() << std::endl;
-        Logger::getInstance().log("添加任务失败: " + std::string(e.what()));
+        return dbError("添加任务失败", e);
     }
 }
 
 
-void TaskManager::deleteTask(int id) {
+OpResult TaskManager::deleteTask(int id) {
+    if (knownMissing(id)) {
+        return notFound(id);
+    }
+    uint64_t generation = cache->generation();
     try {
+        if (sharded()) {
+            // 分片模式下不重整ID
+            OpResult result = published(ChangeType::Delete, shards->remove(id));
+            if (result.status == OpStatus::NotFound) {
+                cache->fillAbsent(id, generation);
+            }
+            return result;
+        }
     std::unique_ptr<sql::PreparedStatement> prepStmt(
-            connection->prepareStatement("DELETE FROM tasks WHERE task_id = ?")
+            db().prepareStatement("DELETE FROM tasks WHERE task_id = ?")
         );
     prepStmt->setInt(1, id);
     int affectedRows = prepStmt->executeUpdate();
 
      if (affectedRows > 0) {
             Logger::getInstance().log("删除任务成功，ID: " + std::to_string(id));
-            std::cout << "任务删除成功。" << std::endl;
+            OpResult result;
+            result.task.id = id;
+            ChangeFeed::getInstance().publish(ChangeType::Delete, result.task);
             // 删除后自动重整ID
-            reorderTaskIDsAfterDelete();
-        } else {
-            std::cout << "未找到ID为 " << id << " 的任务。" << std::endl;
+            OpResult reindexed = reorderTaskIDsAfterDelete();
+            if (!reindexed.ok()) {
+                return failure(OpStatus::Error, "任务已删除，但" + reindexed.message);
+            }
+            return result;
         }
+        cache->fillAbsent(id, generation);
+        return notFound(id);
         
     }catch (sql::SQLException& e) {
-        std::cerr << "删除任务失败: " << e.what() << std::endl;
-        Logger::getInstance().log("删除任务失败: " + std::string(e.what()));
+        return dbError("删除任务失败", e);
     }
 }
-void TaskManager::reorderTaskIDsAfterDelete() {
+OpResult TaskManager::reorderTaskIDsAfterDelete() {
+    OpResult result;
     try {
         // 获取当前所有ID并按顺序重新编号
         std::string reorderQuery = 
@@ -112,7 +231,7 @@ void TaskManager::reorderTaskIDsAfterDelete() {
             "UPDATE tasks SET task_id = (@new_id := @new_id + 1) ORDER BY task_id; "
             "ALTER TABLE tasks AUTO_INCREMENT = (SELECT MAX(task_id) + 1 FROM tasks);";
         
-        std::unique_ptr<sql::Statement> stmt(connection->createStatement());
+        std::unique_ptr<sql::Statement> stmt(db().createStatement());
         stmt->execute("SET @new_id = 0");
         stmt->execute("UPDATE tasks SET task_id = (@new_id := @new_id + 1) ORDER BY task_id");
         
@@ -122,18 +241,27 @@ void TaskManager::reorderTaskIDsAfterDelete() {
             int maxId = res->getInt(1);
             stmt->execute("ALTER TABLE tasks AUTO_INCREMENT = " + std::to_string(maxId + 1));
         }
-        
     } catch (sql::SQLException& e) {
-        std::cerr << "ID重整失败: " << e.what() << std::endl;
+        result = dbError("ID重整失败", e);
     }
+    // ID已整体变化（失败时也可能已部分重编号），通知订阅方和缓存重新同步
+    Task task{0, "", "", 0, "", ""};
+    ChangeFeed::getInstance().publish(ChangeType::Reindex, task);
+    return result;
 }
 
 
-void TaskManager::updateTask(int id, const std::string& title,const std::string& description, int priority, const std::string& dueDate) {
+OpResult TaskManager::updateTask(int id, const std::string& title,const std::string& description, int priority, const std::string& dueDate) {
+    if (knownMissing(id)) {
+        return notFound(id);
+    }
     try {
+        if (sharded()) {
+            return published(ChangeType::Update, shards->update(id, title, description, priority, dueDate));
+        }
         
         std::unique_ptr<sql::PreparedStatement> prepStmt(
-            connection->prepareStatement(
+            db().prepareStatement(
                 "UPDATE tasks SET title = ?, description = ?, priority = ?, due_date = ?, updated_at=CURRENT_TIMESTAMP WHERE task_id = ?"
             )
         );
@@ -148,14 +276,77 @@ void TaskManager::updateTask(int id, const std::string& title,const std::string&
         
         if (affectedRows > 0) {
             Logger::getInstance().log("更新任务成功，ID: " + std::to_string(id));
-            std::cout << "任务更新成功。" << std::endl;
-        } else {
-            std::cout << "未找到ID为 " << id << " 的任务。" << std::endl;
+            OpResult result;
+            if (readTaskFromDb(id, result.task)) {
+                ChangeFeed::getInstance().publish(ChangeType::Update, result.task);
+            }
+            return result;
         }
+        return notFound(id);
         
     } catch (sql::SQLException& e) {
-        std::cerr << "更新任务失败: " << e.what() << std::endl;
-        Logger::getInstance().log("更新任务失败: " + std::string(e.what()));
+        return dbError("更新任务失败", e);
+    }
+}
+
+bool TaskManager::fetchTask(int id, Task& task) const {
+    LookupCache::Lookup cached = cache->get(id, task);
+    if (cached != LookupCache::Lookup::Miss) {
+        return cached == LookupCache::Lookup::Present;
+    }
+    uint64_t generation = cache->generation();
+    bool found = readTaskFromDb(id, task);
+    if (found) {
+        cache->fillPresent(task, generation);
+    } else {
+        cache->fillAbsent(id, generation);
+    }
+    return found;
+}
+
+bool TaskManager::knownMissing(int id) const {
+    Task ignored;
+    return cache->get(id, ignored) == LookupCache::Lookup::Absent;
+}
+
+bool TaskManager::readTaskFromDb(int id, Task& task) const {
+    if (sharded()) {
+        return shards->fetch(id, task);
+    }
+    std::unique_ptr<sql::PreparedStatement> stmt(db().prepareStatement(
+        "SELECT task_id, title, description, priority, due_date, status FROM tasks WHERE task_id = ?"));
+    stmt->setInt(1, id);
+    std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
+    if (!res->next()) {
+        return false;
+    }
+    readTaskRow(*res, task);
+    return true;
+}
+
+OpResult TaskManager::loadTasks(TaskStore& store) const {
+    try {
+        if (sharded()) {
+            std::vector<Task> tasks = shards->list(0);
+            store.reserve(tasks.size());
+            for (const auto& task : tasks) {
+                loadRow(store, task);
+            }
+            return OpResult();
+        }
+        std::unique_ptr<sql::Statement> stmt(db().createStatement());
+        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery(
+            "SELECT task_id, title, description, priority, due_date, status FROM tasks"));
+        store.reserve(res->rowsCount());
+
+        Task task;
+        while (res->next()) {
+            readTaskRow(*res, task);
+            loadRow(store, task);
+        }
+        return OpResult();
+    } catch (sql::SQLException& e) {
+        return dbError("加载任务快照失败", e);
     }
 }
 
@@ -168,27 +359,27 @@ void TaskManager::showStatusOptions() const {
 }
 
 bool TaskManager::isValidStatus(const std::string& status) const {
-    return (status == "pending" || status == "in_progress" || status == "completed");
+    TaskStatus parsed;
+    return parseStatus(status, parsed);
 }
 
-void TaskManager::updateTaskStatus(int id, const std::string& status) {
+OpResult TaskManager::updateTaskStatus(int id, const std::string& status) {
       if (!isValidStatus(status)) {
-        std::cout << "无效状态值。可用状态: pending, in_progress, completed" << std::endl;
-        return;
+        return failure(OpStatus::InvalidArgument, "无效状态值。可用状态: pending, in_progress, completed");
     }
     try {
-        // 首先检查任务是否存在
-        std::unique_ptr<sql::PreparedStatement> checkStmt(
-            connection->prepareStatement("SELECT task_id FROM tasks WHERE task_id = ?")
-        );
-        checkStmt->setInt(1, id);
-        std::unique_ptr<sql::ResultSet> res(checkStmt->executeQuery());
-        
-        if (!res->next()) {
-            std::cout << "未找到ID为 " << id << " 的任务。" << std::endl;
-            return;
+        // 首先检查任务是否存在（优先查缓存）
+        OpResult result;
+        if (!fetchTask(id, result.task)) {
+            return notFound(id);
         }
-        std::unique_ptr<sql::PreparedStatement> pstmt(connection->prepareStatement(
+        if (result.task.status == status) {
+            return result; // 状态未变化，无需访问数据库
+        }
+        if (sharded()) {
+            return published(ChangeType::Status, shards->updateStatus(id, status));
+        }
+        std::unique_ptr<sql::PreparedStatement> pstmt(db().prepareStatement(
             "UPDATE tasks SET status = ? WHERE task_id = ?"));
         
         pstmt->setString(1, status);
@@ -197,111 +388,74 @@ void TaskManager::updateTaskStatus(int id, const std::string& status) {
         int affectedRows = pstmt->executeUpdate();
         
         if (affectedRows > 0) {
-           // 获取更新后的任务信息用于日志
-            std::unique_ptr<sql::PreparedStatement> getStmt(
-                connection->prepareStatement("SELECT title FROM tasks WHERE task_id = ?")
-            );
-            getStmt->setInt(1, id);
-            std::unique_ptr<sql::ResultSet> taskRes(getStmt->executeQuery());
-            
-            std::string taskTitle = "Unknown";
-            if (taskRes->next()) {
-                taskTitle = taskRes->getString("title");
+            // 回读实际存储的行再发布，缓存中的行可能已过期
+            if (!readTaskFromDb(id, result.task)) {
+                return notFound(id);
             }
+            ChangeFeed::getInstance().publish(ChangeType::Status, result.task);
             
             Logger::getInstance().log("更新任务状态 ID: " + std::to_string(id) + 
-                                    " 标题: " + taskTitle + " 状态: " + status);
-            std::cout << "任务状态更新成功！" << std::endl;
-            
-            // 显示状态变更信息
-            std::cout << "任务 '" << taskTitle << "' 的状态已更新为: ";
-            if (status == "pending") std::cout << "待处理";
-            else if (status == "in_progress") std::cout << "进行中";
-            else if (status == "completed") std::cout << "已完成";
-            std::cout << std::endl;
-        } else {
-            std::cout << "未找到ID为 " << id << " 的任务。" << std::endl;
+                                    " 标题: " + result.task.title + " 状态: " + status);
+            return result;
         }
+        return notFound(id);
     } catch (sql::SQLException& e) {
-        std::cerr << "更新任务状态失败: " << e.what() << std::endl;
-        Logger::getInstance().log("更新任务状态失败: " + std::string(e.what()));
+        return dbError("更新任务状态失败", e);
     }
 }
 
 // 添加按状态筛选任务的方法
-void TaskManager::listTasksByStatus(const std::string& status) const {
+TaskRows TaskManager::openTasksByStatus(const std::string& status) const {
+    if (sharded()) {
+        return TaskRows(shards->list(0, status));
+    }
+    std::string query = "SELECT task_id, title, description, priority, due_date, status FROM tasks WHERE status = ? ORDER BY task_id";
+    
+    std::unique_ptr<sql::PreparedStatement> stmt(db().prepareStatement(query));
+    stmt->setString(1, status);
+    std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
+    return TaskRows(std::move(stmt), std::move(res));
+}
+
+TaskRows TaskManager::openTasks(int sortOption) const {
+    if (sharded()) {
+        return TaskRows(shards->list(sortOption));
+    }
+    std::string query = "SELECT task_id, title, description, priority, due_date, status FROM tasks";
+    switch (sortOption) {
+        case 1: query += " ORDER BY priority"; break;
+        case 2: query += " ORDER BY due_date"; break;
+        default: query += " ORDER BY task_id"; 
+    }
+    
+    std::unique_ptr<sql::Statement> stmt(db().createStatement());
+    std::unique_ptr<sql::ResultSet> res(stmt->executeQuery(query));
+    return TaskRows(std::move(stmt), std::move(res));
+}
+
+QueryResult TaskManager::listTasksByStatus(const std::string& status) const {
+    QueryResult result;
     try {
-        std::string query = "SELECT task_id, title, description, priority, due_date, status FROM tasks WHERE status = ? ORDER BY task_id";
-        
-        std::unique_ptr<sql::PreparedStatement> stmt(connection->prepareStatement(query));
-        stmt->setString(1, status);
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
-        
-        std::cout << "状态为 '";
-        if (status == "pending") std::cout << "待处理";
-        else if (status == "in_progress") std::cout << "进行中";
-        else if (status == "completed") std::cout << "已完成";
-        std::cout << "' 的任务列表:" << std::endl;
-        
-        TableFormatter::printHeader();
-        
-        bool hasTasks = false;
-        while (res->next()) {
-            hasTasks = true;
-            std::cout << TableFormatter::formatTask(
-                res->getInt("task_id"),
-                res->getString("title"),
-                res->getInt("priority"),
-                res->getString("due_date"),
-                res->getString("status"),
-                res->getString("description")
-            ) << std::endl;
-        }
-        
-        if (!hasTasks) {
-            std::cout << "没有找到相应状态的任务。" << std::endl;
-        }
-        
+        TaskRows rows = openTasksByStatus(status);
+        result.tasks = rows.materialize();
     } catch (sql::SQLException& e) {
-        std::cerr << "按状态查询任务失败: " << e.what() << std::endl;
         Logger::getInstance().log("按状态查询任务失败: " + std::string(e.what()));
+        result.status = OpStatus::Error;
+        result.message = "按状态查询任务失败: " + std::string(e.what());
     }
+    return result;
 }
 
-void TaskManager::listTasks(int sortOption) const {
+QueryResult TaskManager::listTasks(int sortOption) const {
      // 直接从数据库实时查询，确保数据最新
+    QueryResult result;
     try {
-      
-        std::string query = "SELECT task_id, title, description, priority, due_date, status FROM tasks";
-        switch (sortOption) {
-            case 1: query += " ORDER BY priority"; break;
-            case 2: query += " ORDER BY due_date"; break;
-            default: query += " ORDER BY task_id"; 
-        }
-        
-        std::unique_ptr<sql::Statement> stmt(connection->createStatement());
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery(query));
-        
-        std::cout << "任务列表:" << std::endl;
-       
-         TableFormatter::printHeader();  // 使用统一的表头输出
-        
-        while (res->next()) {
-            std::cout << TableFormatter::formatTask(
-                res->getInt("task_id"),
-                res->getString("title"),
-                res->getInt("priority"),
-                res->getString("due_date"),
-                res->getString("status"),
-                res->getString("description")
-            ) << std::endl;
-        }
-        
+        TaskRows rows = openTasks(sortOption);
+        result.tasks = rows.materialize();
     } catch (sql::SQLException& e) {
-        std::cerr << "查询任务失败: " << e.what() << std::endl;
          Logger::getInstance().log("查询任务失败: " + std::string(e.what()));
-    
+         result.status = OpStatus::Error;
+         result.message = "查询任务失败: " + std::string(e.what());
     }
+    return result;
 }
-
-
@@ -4,6 +4,11 @@
 
 
 #include "Task.h"
+#include "TaskResult.h"
+#include "TaskStore.h"
+#include "TaskRows.h"
+#include "ShardedTaskStore.h"
+#include "LookupCache.h"
 #include <vector>
 #include <string>
 #include <memory>
@@ -14,26 +19,61 @@
 
 class TaskManager {
 public:
-    TaskManager();
+    // shardCount > 1 时按ID哈希把任务分布到多个 schema（见 ShardedTaskStore）
+    // lookupCache 可在多个 TaskManager 间共享，为空时使用独立的缓存
+    // fastStart 为 true 时不在构造时连接，首次操作时才连接；本地 schema 版本缓存一致时跳过DDL
+    // schemaReady 为 true 表示同组的其他连接已完成建库建表和分片布局检查：首次操作时才连接，直接使用现有 schema
+    explicit TaskManager(size_t shardCount = 1, std::shared_ptr<LookupCache> lookupCache = nullptr,
+                         bool fastStart = false, bool schemaReady = false);
     ~TaskManager();
 
    
-    void addTask(const std::string& title,const std::string& description, int priority, const std::string& dueDate);
-    void deleteTask(int id);
-    void reorderTaskIDsAfterDelete();
-    void updateTask(int id, const std::string& title,const std::string& description, int priority, const std::string& dueDate);
-    void listTasks(int sortOption = 0) const; // 0-按ID, 1-按优先级, 2-按截止日期
+    OpResult addTask(const std::string& title,const std::string& description, int priority, const std::string& dueDate);
+    OpResult deleteTask(int id);
+    OpResult reorderTaskIDsAfterDelete(); // 无论成败都会发布 Reindex
+    OpResult updateTask(int id, const std::string& title,const std::string& description, int priority, const std::string& dueDate);
+    QueryResult listTasks(int sortOption = 0) const; // 0-按ID, 1-按优先级, 2-按截止日期
     
 
-    void updateTaskStatus(int id, const std::string& status) ;
-    void listTasksByStatus(const std::string& status)  const;
+    OpResult updateTaskStatus(int id, const std::string& status) ;
+    QueryResult listTasksByStatus(const std::string& status)  const;
     void showStatusOptions()  const;
     bool isValidStatus(const std::string& status) const;
 
+    // 惰性行视图：不物化整张结果表，逐行读取（数据库异常向上抛出）
+    TaskRows openTasks(int sortOption = 0) const;
+    TaskRows openTasksByStatus(const std::string& status) const;
+
+    // 按ID读取单个任务（经过点查询缓存），不存在时返回false（数据库异常向上抛出）
+    bool fetchTask(int id, Task& task) const;
+    // 绕过缓存直接从数据库读取（写操作后回读、基准测试）
+    bool readTaskFromDb(int id, Task& task) const;
+
+    // 全量读取所有任务到紧凑存储中
+    OpResult loadTasks(TaskStore& store) const;
+
+    size_t shardCount() const { return requestedShards; }
+
 private:
-    std::unique_ptr<sql::Connection> connection;
-    void establishConnection(); // 建立数据库连接
-    void initializeDatabase();
+    // 连接在首次使用时建立，因此以下成员在 const 方法中也可能被初始化
+    mutable std::unique_ptr<sql::Connection> connection;
+    mutable std::unique_ptr<ShardedTaskStore> shards; // 为空表示单库模式
+    mutable bool connected = false;
+    std::shared_ptr<LookupCache> cache;
+    size_t requestedShards;
+    bool fastStart;
+    bool schemaReady;
+
+    // 惰性连接：首次调用时连接并初始化（失败时抛出 sql::SQLException）
+    void ensureConnected() const;
+    sql::Connection& db() const { ensureConnected(); return *connection; }
+    ShardedTaskStore* sharded() const { ensureConnected(); return shards.get(); }
+
+    bool knownMissing(int id) const; // 负缓存命中时无需访问数据库
+    void establishConnection() const; // 建立数据库连接
+    bool initializeDatabase(std::string& error) const; // 成功后才记录 schema 版本
+    void openShards(size_t shardCount) const;
+    void checkSingleLayout() const; // 数据已按多个分片存放时拒绝以单库模式访问
     
 };
 
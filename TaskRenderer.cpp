@@ -0,0 +1,118 @@
+﻿//TaskRenderer.cpp
+#include "TaskRenderer.h"
+#include "TableFormatter.h"
+#include <cstdio>
+
+
+std::string escapeTsv(const std::string& str) {
+    std::string result;
+    result.reserve(str.size());
+    for (char c : str) {
+        switch (c) {
+            case '\t': result += "\\t"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\\': result += "\\\\"; break;
+            default: result += c;
+        }
+    }
+    return result;
+}
+
+
+std::string escapeJson(const std::string& str) {
+    std::string result;
+    result.reserve(str.size() + 2);
+    for (char c : str) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+                    result += buf;
+                } else {
+                    result += c; // UTF-8 多字节字符原样输出
+                }
+        }
+    }
+    return result;
+}
+
+
+size_t TaskRenderer::render(const std::string& title, const std::vector<Task>& tasks) {
+    begin(title);
+    for (const auto& task : tasks) {
+        row(task);
+    }
+    end(tasks.size());
+    return tasks.size();
+}
+
+
+void TableRenderer::begin(const std::string& title) {
+    if (!title.empty()) {
+        out << title << std::endl;
+    }
+    TableFormatter::printHeader(out);
+}
+
+
+void TableRenderer::row(const Task& task) {
+    out << task.toString() << '\n';
+}
+
+
+void TableRenderer::end(size_t count) {
+    if (count == 0 && !emptyMessage.empty()) {
+        out << emptyMessage << '\n';
+    }
+    TaskRenderer::end(count);
+}
+
+
+void TsvRenderer::begin(const std::string& title) {
+    (void)title;
+    out << "id\ttitle\tpriority\tdue_date\tstatus\tdescription\n";
+}
+
+
+void TsvRenderer::row(const Task& task) {
+    out << task.id << '\t' << escapeTsv(task.title) << '\t' << task.priority << '\t'
+        << escapeTsv(task.dueDate) << '\t' << escapeTsv(task.status) << '\t'
+        << escapeTsv(task.description) << '\n';
+}
+
+
+void JsonLinesRenderer::row(const Task& task) {
+    out << "{\"id\":" << task.id
+        << ",\"title\":\"" << escapeJson(task.title)
+        << "\",\"priority\":" << task.priority
+        << ",\"due_date\":";
+    if (task.dueDate.empty()) {
+        out << "null";
+    } else {
+        out << '"' << escapeJson(task.dueDate) << '"';
+    }
+    out << ",\"status\":\"" << escapeJson(task.status)
+        << "\",\"description\":\"" << escapeJson(task.description) << "\"}\n";
+}
+
+
+std::unique_ptr<TaskRenderer> makeRenderer(const std::string& format, std::ostream& out,
+                                           const std::string& emptyMessage) {
+    if (format.empty() || format == "table") {
+        return std::make_unique<TableRenderer>(out, emptyMessage);
+    }
+    if (format == "tsv") {
+        return std::make_unique<TsvRenderer>(out);
+    }
+    if (format == "json") {
+        return std::make_unique<JsonLinesRenderer>(out);
+    }
+    return nullptr;
+}
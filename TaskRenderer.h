@@ -0,0 +1,93 @@
+﻿//TaskRenderer.h
+#ifndef TASKRENDERER_H
+#define TASKRENDERER_H
+
+
+#include "Task.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+// 转义 TSV 字段中的制表符、换行和反斜杠
+std::string escapeTsv(const std::string& str);
+// 转义 JSON 字符串内容（不含两侧引号）
+std::string escapeJson(const std::string& str);
+
+
+// 任务列表的渲染器：查询与输出分离，同一份结果可以按不同格式输出
+class TaskRenderer {
+public:
+    explicit TaskRenderer(std::ostream& out) : out(out) {}
+    virtual ~TaskRenderer() = default;
+
+    // title 仅供面向人的格式使用
+    virtual void begin(const std::string& title) { (void)title; }
+    virtual void row(const Task& task) = 0;
+    virtual void end(size_t count) { (void)count; out.flush(); }
+
+    // 渲染可逐行读取的来源（提供 bool next(Task&)，如 TaskRows），返回行数
+    template <typename Rows>
+    size_t render(const std::string& title, Rows& rows);
+    size_t render(const std::string& title, const std::vector<Task>& tasks);
+    size_t render(const std::string& title, std::vector<Task>& tasks) {
+        return render(title, static_cast<const std::vector<Task>&>(tasks));
+    }
+
+protected:
+    std::ostream& out;
+};
+
+
+// 对齐的表格（原有的控制台输出格式）
+class TableRenderer : public TaskRenderer {
+public:
+    explicit TableRenderer(std::ostream& out, std::string emptyMessage = "")
+        : TaskRenderer(out), emptyMessage(std::move(emptyMessage)) {}
+    void begin(const std::string& title) override;
+    void row(const Task& task) override;
+    void end(size_t count) override;
+
+private:
+    std::string emptyMessage; // 没有任何行时输出的提示
+};
+
+
+// 制表符分隔，首行为列名
+class TsvRenderer : public TaskRenderer {
+public:
+    using TaskRenderer::TaskRenderer;
+    void begin(const std::string& title) override;
+    void row(const Task& task) override;
+};
+
+
+// 每行一个 JSON 对象
+class JsonLinesRenderer : public TaskRenderer {
+public:
+    using TaskRenderer::TaskRenderer;
+    void row(const Task& task) override;
+};
+
+
+// 按名称创建渲染器: table, tsv, json；名称无效时返回空指针
+std::unique_ptr<TaskRenderer> makeRenderer(const std::string& format, std::ostream& out,
+                                           const std::string& emptyMessage = "");
+
+
+template <typename Rows>
+size_t TaskRenderer::render(const std::string& title, Rows& rows) {
+    begin(title);
+    size_t count = 0;
+    Task task;
+    while (rows.next(task)) {
+        row(task);
+        ++count;
+    }
+    end(count);
+    return count;
+}
+
+
+#endif // TASKRENDERER_H
@@ -0,0 +1,49 @@
+﻿//TaskResult.h
+#ifndef TASKRESULT_H
+#define TASKRESULT_H
+
+
+#include "Task.h"
+#include <string>
+#include <vector>
+
+
+// 操作结果状态
+enum class OpStatus {
+    Ok,
+    NotFound,
+    InvalidArgument,
+    Error
+};
+
+// 单个任务操作的结果，不直接输出，由调用方决定如何展示
+struct OpResult {
+    OpStatus status = OpStatus::Ok;
+    Task task{};         // 受影响的任务（成功时有效）
+    std::string message; // 失败原因
+
+    bool ok() const { return status == OpStatus::Ok; }
+};
+
+// 查询结果
+struct QueryResult {
+    OpStatus status = OpStatus::Ok;
+    std::vector<Task> tasks;
+    std::string message;
+
+    bool ok() const { return status == OpStatus::Ok; }
+};
+
+inline OpResult failure(OpStatus status, const std::string& message) {
+    OpResult result;
+    result.status = status;
+    result.message = message;
+    return result;
+}
+
+inline OpResult notFound(int id) {
+    return failure(OpStatus::NotFound, "未找到ID为 " + std::to_string(id) + " 的任务。");
+}
+
+
+#endif // TASKRESULT_H
@@ -0,0 +1,81 @@
+﻿//TaskRows.h
+#ifndef TASKROWS_H
+#define TASKROWS_H
+
+
+#include "Task.h"
+#include <memory>
+#include <vector>
+#include <cppconn/resultset.h>
+#include <cppconn/statement.h>
+
+
+// 把结果集当前行转换为 Task，所有读取 tasks 表的地方共用这一处列映射
+inline void readTaskRow(sql::ResultSet& res, Task& task) {
+    task.id = res.getInt("task_id");
+    task.title = res.getString("title");
+    task.description = res.getString("description");
+    task.priority = res.getInt("priority");
+    task.dueDate = res.getString("due_date");
+    task.status = res.getString("status");
+}
+
+
+// 查询结果的惰性行视图：只在 next() 时把当前行转换为 Task
+// 只能移动不能拷贝；不可超出产生它的 TaskManager（数据库连接）的使用期
+// 分片模式下结果已在内存中归并完成，此时视图直接遍历归并后的任务
+class TaskRows {
+public:
+    TaskRows() = default;
+    TaskRows(std::unique_ptr<sql::Statement> stmt, std::unique_ptr<sql::ResultSet> res)
+        : statement(std::move(stmt)), results(std::move(res)) {}
+    explicit TaskRows(std::vector<Task> tasks) : buffered(std::move(tasks)) {}
+
+    TaskRows(TaskRows&&) = default;
+    TaskRows& operator=(TaskRows&&) = default;
+    TaskRows(const TaskRows&) = delete;
+    TaskRows& operator=(const TaskRows&) = delete;
+
+    // 读取下一行到 task，没有更多行时返回 false
+    bool next(Task& task) {
+        if (!results) {
+            if (cursor >= buffered.size()) {
+                return false;
+            }
+            task = std::move(buffered[cursor++]);
+            return true;
+        }
+        if (!results->next()) {
+            return false;
+        }
+        readTaskRow(*results, task);
+        return true;
+    }
+
+    size_t size() const { return results ? results->rowsCount() : buffered.size(); }
+
+    // 把剩余所有行物化为 vector（预先分配容量）
+    std::vector<Task> materialize() {
+        std::vector<Task> tasks;
+        if (!results && cursor == 0) {
+            tasks.swap(buffered);
+            return tasks;
+        }
+        tasks.reserve(size());
+        Task task;
+        while (next(task)) {
+            tasks.push_back(std::move(task));
+        }
+        return tasks;
+    }
+
+private:
+    // 声明顺序保证结果集先于语句释放
+    std::unique_ptr<sql::Statement> statement;
+    std::unique_ptr<sql::ResultSet> results;
+    std::vector<Task> buffered;
+    size_t cursor = 0;
+};
+
+
+#endif // TASKROWS_H
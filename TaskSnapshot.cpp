@@ -0,0 +1,60 @@
+﻿//TaskSnapshot.cpp
+#include "TaskSnapshot.h"
+#include "ChangeFeed.h"
+#include "Logger.h"
+#include "TaskManager.h"
+#include <stdexcept>
+
+
+constexpr std::chrono::milliseconds TaskSnapshot::DEFAULT_MAX_AGE;
+
+
+SyncResult TaskSnapshot::refresh(TaskManager& manager) {
+    if (!loaded || Clock::now() - loadedAt >= maxAge) {
+        return reload(manager);
+    }
+
+    ChangeFeed& feed = ChangeFeed::getInstance();
+    bool truncated = false;
+    std::vector<ChangeEvent> events = feed.readFrom(offset, ChangeFeed::CAPACITY, &truncated);
+    if (truncated) {
+        return reload(manager);
+    }
+    for (const auto& event : events) {
+        switch (event.type) {
+            case ChangeType::Add:
+            case ChangeType::Update:
+            case ChangeType::Status:
+                try {
+                    tasks.upsert(event.task);
+                } catch (const std::invalid_argument& e) {
+                    Logger::getInstance().log("快照跳过任务 ID " + std::to_string(event.task.id) + ": " + e.what());
+                }
+                break;
+            case ChangeType::Delete:
+                tasks.remove(event.task.id);
+                break;
+            case ChangeType::Reindex:
+                return reload(manager);
+        }
+        offset = event.seq + 1;
+    }
+    return SyncResult::Incremental;
+}
+
+
+SyncResult TaskSnapshot::reload(TaskManager& manager) {
+    // 先记录偏移量再加载，加载期间发生的变更会在下次同步时重放（upsert/remove 可重复执行）
+    offset = ChangeFeed::getInstance().nextSeq();
+    tasks.clear();
+    OpResult result = manager.loadTasks(tasks);
+    loaded = result.ok();
+    if (!loaded) {
+        lastError = result.message;
+        tasks.clear(); // 不保留加载了一半的数据
+        return SyncResult::Failed;
+    }
+    loadedAt = Clock::now();
+    Logger::getInstance().log("任务快照已重新加载，任务数: " + std::to_string(tasks.size()));
+    return SyncResult::Reloaded;
+}
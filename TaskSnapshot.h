@@ -0,0 +1,50 @@
+﻿//TaskSnapshot.h
+#ifndef TASKSNAPSHOT_H
+#define TASKSNAPSHOT_H
+
+
+#include "TaskStore.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+class TaskManager;
+
+
+// 快照同步结果
+enum class SyncResult {
+    Incremental, // 通过变更流增量同步
+    Reloaded,    // 从数据库全量加载
+    Failed       // 全量加载失败，快照为空，下次同步时重试
+};
+
+
+// 任务快照：首次使用时从数据库全量加载，之后通过变更流增量同步
+// 变更流只包含本进程的写入，因此超过最大存活时间后也会全量重新加载，以纳入其他进程的修改
+class TaskSnapshot {
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_MAX_AGE{60000};
+
+    explicit TaskSnapshot(std::chrono::milliseconds maxAge = DEFAULT_MAX_AGE) : maxAge(maxAge) {}
+
+    // 应用自上次同步以来的变更；变更流被截断、ID重整或快照过期时重新全量加载
+    SyncResult refresh(TaskManager& manager);
+
+    const TaskStore& store() const { return tasks; }
+    const std::string& error() const { return lastError; } // 最近一次加载失败的原因
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    SyncResult reload(TaskManager& manager);
+
+    TaskStore tasks;
+    uint64_t offset = 0;
+    bool loaded = false;
+    Clock::time_point loadedAt;
+    std::chrono::milliseconds maxAge;
+    std::string lastError;
+};
+
+
+#endif // TASKSNAPSHOT_H
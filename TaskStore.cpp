@@ -0,0 +1,292 @@
+﻿//TaskStore.cpp
+#include "TaskStore.h"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+
+const uint32_t TaskStore::NPOS;
+const int TaskStore::DENSE_ID_LIMIT;
+
+bool parseStatus(const std::string& str, TaskStatus& status) {
+    if (str == "pending") {
+        status = TaskStatus::Pending;
+    } else if (str == "in_progress") {
+        status = TaskStatus::InProgress;
+    } else if (str == "completed") {
+        status = TaskStatus::Completed;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+
+const char* statusName(TaskStatus status) {
+    switch (status) {
+        case TaskStatus::Pending: return "pending";
+        case TaskStatus::InProgress: return "in_progress";
+        case TaskStatus::Completed: return "completed";
+    }
+    return "";
+}
+
+
+uint8_t packPriority(int priority) {
+    return static_cast<uint8_t>(std::min(std::max(priority, 0), 255));
+}
+
+
+namespace {
+
+int daysInMonth(int y, int m) {
+    static const int DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    return m == 2 && leap ? 29 : DAYS[m - 1];
+}
+
+} // namespace
+
+
+// 公历日期与天数互转（proleptic Gregorian，算法见 Howard Hinnant 的 days_from_civil）
+int32_t parseDueDate(const std::string& date) {
+    int y, m, d;
+    if (date.size() < 10 || std::sscanf(date.c_str(), "%4d-%2d-%2d", &y, &m, &d) != 3 ||
+        m < 1 || m > 12 || d < 1 || d > daysInMonth(y, m)) {
+        return NO_DUE_DATE;
+    }
+    y -= m <= 2;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int32_t>(doe) - 719468;
+}
+
+
+std::string formatDueDate(int32_t day) {
+    if (day == NO_DUE_DATE) {
+        return "";
+    }
+    int32_t z = day + 719468;
+    const int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    const int y = static_cast<int>(yoe) + era * 400 + (m <= 2);
+
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u", y, m, d);
+    return buf;
+}
+
+
+StringRef StringArena::append(const std::string& str) {
+    if (buffer.size() + str.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("StringArena 超出 4GB 上限");
+    }
+    StringRef ref{static_cast<uint32_t>(buffer.size()), static_cast<uint32_t>(str.size())};
+    buffer.insert(buffer.end(), str.begin(), str.end());
+    return ref;
+}
+
+
+void TaskStore::reserve(size_t count, size_t stringBytes) {
+    ids.reserve(count);
+    priorities.reserve(count);
+    statuses.reserve(count);
+    dueDays.reserve(count);
+    titles.reserve(count);
+    descriptions.reserve(count);
+    strings.reserve(stringBytes);
+}
+
+
+void TaskStore::clear() {
+    ids.clear();
+    priorities.clear();
+    statuses.clear();
+    dueDays.clear();
+    titles.clear();
+    descriptions.clear();
+    strings.clear();
+    garbageBytes = 0;
+    rowById.clear();
+    sparseRows.clear();
+}
+
+
+uint32_t TaskStore::upsert(const Task& task) {
+    if (task.id < 0) {
+        throw std::invalid_argument("任务ID不能为负数");
+    }
+    TaskStatus status;
+    if (!parseStatus(task.status, status)) {
+        throw std::invalid_argument("未知任务状态: " + task.status);
+    }
+
+    uint32_t row = find(task.id);
+    if (row == NPOS) {
+        row = static_cast<uint32_t>(ids.size());
+        ids.push_back(task.id);
+        priorities.push_back(packPriority(task.priority));
+        statuses.push_back(status);
+        dueDays.push_back(parseDueDate(task.dueDate));
+        titles.push_back(strings.append(task.title));
+        descriptions.push_back(strings.append(task.description));
+
+        setRow(task.id, row);
+        return row;
+    }
+
+    priorities[row] = packPriority(task.priority);
+    statuses[row] = status;
+    dueDays[row] = parseDueDate(task.dueDate);
+    eraseString(titles[row]);
+    eraseString(descriptions[row]);
+    titles[row] = strings.append(task.title);
+    descriptions[row] = strings.append(task.description);
+    if (garbageBytes > strings.size() / 2) {
+        compactStrings();
+    }
+    return row;
+}
+
+
+bool TaskStore::remove(int id) {
+    uint32_t row = find(id);
+    if (row == NPOS) {
+        return false;
+    }
+    eraseString(titles[row]);
+    eraseString(descriptions[row]);
+
+    // 与最后一行交换后删除，保持各列连续
+    uint32_t last = static_cast<uint32_t>(ids.size() - 1);
+    if (row != last) {
+        ids[row] = ids[last];
+        priorities[row] = priorities[last];
+        statuses[row] = statuses[last];
+        dueDays[row] = dueDays[last];
+        titles[row] = titles[last];
+        descriptions[row] = descriptions[last];
+        setRow(ids[row], row);
+    }
+    ids.pop_back();
+    priorities.pop_back();
+    statuses.pop_back();
+    dueDays.pop_back();
+    titles.pop_back();
+    descriptions.pop_back();
+    if (id < DENSE_ID_LIMIT) {
+        rowById[id] = NPOS;
+    } else {
+        sparseRows.erase(id);
+    }
+
+    if (garbageBytes > strings.size() / 2) {
+        compactStrings();
+    }
+    return true;
+}
+
+
+uint32_t TaskStore::find(int id) const {
+    if (id < 0) {
+        return NPOS;
+    }
+    if (id >= DENSE_ID_LIMIT) {
+        auto it = sparseRows.find(id);
+        return it == sparseRows.end() ? NPOS : it->second;
+    }
+    return static_cast<size_t>(id) < rowById.size() ? rowById[id] : NPOS;
+}
+
+
+void TaskStore::setRow(int id, uint32_t row) {
+    if (id >= DENSE_ID_LIMIT) {
+        sparseRows[id] = row;
+        return;
+    }
+    size_t index = static_cast<size_t>(id);
+    if (index >= rowById.size()) {
+        size_t grown = std::min<size_t>(std::max(index + 1, rowById.size() * 2), DENSE_ID_LIMIT);
+        rowById.resize(grown, NPOS);
+    }
+    rowById[index] = row;
+}
+
+
+Task TaskStore::get(uint32_t row) const {
+    return Task{ids[row], strings.get(titles[row]), strings.get(descriptions[row]),
+                priorities[row], formatDueDate(dueDays[row]), statusName(statuses[row])};
+}
+
+
+std::vector<uint32_t> TaskStore::filterByStatus(TaskStatus status) const {
+    std::vector<uint32_t> rows;
+    const size_t n = statuses.size();
+    const TaskStatus* col = statuses.data();
+    for (size_t i = 0; i < n; ++i) {
+        if (col[i] == status) {
+            rows.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return rows;
+}
+
+
+uint64_t TaskStore::sortKey(uint32_t row, int sortOption) const {
+    uint32_t major = 0;
+    switch (sortOption) {
+        case 1: major = priorities[row]; break;
+        // 有符号天数加偏置转为无符号，保持大小顺序
+        case 2: major = static_cast<uint32_t>(dueDays[row]) ^ 0x80000000u; break;
+        default: break;
+    }
+    return (static_cast<uint64_t>(major) << 32) | static_cast<uint32_t>(ids[row]);
+}
+
+
+std::vector<uint32_t> TaskStore::sortedRows(int sortOption) const {
+    // 先把 (排序字段, ID) 打包成整数排序，再通过 ID 表换回行号，避免排序时随机访问各列
+    std::vector<uint64_t> keys(ids.size());
+    for (uint32_t row = 0; row < keys.size(); ++row) {
+        keys[row] = sortKey(row, sortOption);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<uint32_t> rows(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        rows[i] = find(static_cast<int>(static_cast<uint32_t>(keys[i])));
+    }
+    return rows;
+}
+
+
+size_t TaskStore::memoryUsage() const {
+    return ids.capacity() * sizeof(int32_t)
+         + priorities.capacity() * sizeof(uint8_t)
+         + statuses.capacity() * sizeof(TaskStatus)
+         + dueDays.capacity() * sizeof(int32_t)
+         + titles.capacity() * sizeof(StringRef)
+         + descriptions.capacity() * sizeof(StringRef)
+         + strings.capacity()
+         + rowById.capacity() * sizeof(uint32_t)
+         + sparseRows.size() * (sizeof(std::pair<const int, uint32_t>) + 2 * sizeof(void*)); // 节点开销估算
+}
+
+
+void TaskStore::compactStrings() {
+    StringArena compacted;
+    compacted.reserve(strings.size() - garbageBytes);
+    for (size_t row = 0; row < ids.size(); ++row) {
+        titles[row] = compacted.append(strings.get(titles[row]));
+        descriptions[row] = compacted.append(strings.get(descriptions[row]));
+    }
+    strings = std::move(compacted);
+    garbageBytes = 0;
+}
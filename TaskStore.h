@@ -0,0 +1,118 @@
+﻿//TaskStore.h
+#ifndef TASKSTORE_H
+#define TASKSTORE_H
+
+
+#include "Task.h"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// 任务状态（与数据库 ENUM 顺序一致）
+enum class TaskStatus : uint8_t {
+    Pending = 0,
+    InProgress = 1,
+    Completed = 2
+};
+
+const int TASK_STATUS_COUNT = 3;
+
+bool parseStatus(const std::string& str, TaskStatus& status);
+const char* statusName(TaskStatus status);
+uint8_t packPriority(int priority); // 优先级存储为单字节，超出范围的数值截断到 [0, 255]
+
+// 截止日期压缩为自 1970-01-01 起的天数，无日期时为 NO_DUE_DATE（排序时排在最前，与 MySQL 对 NULL 的处理一致）
+const int32_t NO_DUE_DATE = std::numeric_limits<int32_t>::min();
+int32_t parseDueDate(const std::string& date); // "YYYY-MM-DD"，格式错误返回 NO_DUE_DATE
+std::string formatDueDate(int32_t day);
+
+
+// 字符串在 arena 中的位置
+struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+
+// 只追加的字符串堆：所有标题/描述连续存放，避免每个字符串单独分配
+class StringArena {
+public:
+    StringRef append(const std::string& str);
+    std::string get(StringRef ref) const { return std::string(buffer.data() + ref.offset, ref.length); }
+    size_t size() const { return buffer.size(); }
+    size_t capacity() const { return buffer.capacity(); }
+    void reserve(size_t bytes) { buffer.reserve(bytes); }
+    void clear() { buffer.clear(); }
+
+private:
+    std::vector<char> buffer;
+};
+
+
+// 面向缓存的任务存储：热字段按列（SoA）存放，字符串放在 arena 中
+// 单库模式下任务ID是连续的（删除后会重整），因此小ID用直接寻址表做 ID -> 行号映射；
+// 分片模式不重整ID，ID 可能稀疏，超过 DENSE_ID_LIMIT 的ID改用哈希表，避免按ID大小分配内存
+class TaskStore {
+public:
+    static const uint32_t NPOS = std::numeric_limits<uint32_t>::max();
+    static const int DENSE_ID_LIMIT = 1 << 22; // 直接寻址表最多 16MB
+
+    void reserve(size_t count, size_t stringBytes = 0);
+    void clear();
+    size_t size() const { return ids.size(); }
+
+    // 插入或覆盖同ID的任务，返回行号；ID为负数或状态未知时抛出 std::invalid_argument
+    uint32_t upsert(const Task& task);
+    bool remove(int id);
+    uint32_t find(int id) const;
+
+    // 物化为 Task（只在需要输出时调用）
+    Task get(uint32_t row) const;
+
+    int id(uint32_t row) const { return ids[row]; }
+    uint8_t priority(uint32_t row) const { return priorities[row]; }
+    TaskStatus status(uint32_t row) const { return statuses[row]; }
+    int32_t dueDay(uint32_t row) const { return dueDays[row]; }
+
+    // 列访问，供批量扫描使用
+    const std::vector<int32_t>& idColumn() const { return ids; }
+    const std::vector<uint8_t>& priorityColumn() const { return priorities; }
+    const std::vector<TaskStatus>& statusColumn() const { return statuses; }
+    const std::vector<int32_t>& dueDayColumn() const { return dueDays; }
+
+    // 返回指定状态的行号（按行号顺序）
+    std::vector<uint32_t> filterByStatus(TaskStatus status) const;
+
+    // 按排序选项返回行号: 0-按ID, 1-按优先级, 2-按截止日期（后两者以ID为次序键）
+    std::vector<uint32_t> sortedRows(int sortOption) const;
+
+    // 排序键：高32位为排序字段，低32位为ID，可直接按整数比较
+    uint64_t sortKey(uint32_t row, int sortOption) const;
+
+    // 当前占用的内存字节数（按容量计算）
+    size_t memoryUsage() const;
+
+private:
+    void eraseString(StringRef ref) { garbageBytes += ref.length; }
+    void compactStrings();
+
+    std::vector<int32_t> ids;
+    std::vector<uint8_t> priorities;
+    std::vector<TaskStatus> statuses;
+    std::vector<int32_t> dueDays;
+    std::vector<StringRef> titles;
+    std::vector<StringRef> descriptions;
+    StringArena strings;
+    size_t garbageBytes = 0;
+
+    void setRow(int id, uint32_t row);
+
+    std::vector<uint32_t> rowById; // 下标为任务ID（< DENSE_ID_LIMIT）
+    std::unordered_map<int, uint32_t> sparseRows; // 其余ID
+};
+
+
+#endif // TASKSTORE_H
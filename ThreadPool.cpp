@@ -0,0 +1,66 @@
+﻿//ThreadPool.cpp
+#include "ThreadPool.h"
+#include <algorithm>
+
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    threadCount = std::max<size_t>(threadCount, 1);
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping && jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop();
+        }
+        job();
+    }
+}
+
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)>& body, size_t minChunk) {
+    if (count == 0) {
+        return;
+    }
+    size_t chunks = std::min(workers.size() * 4, (count + minChunk - 1) / minChunk);
+    if (chunks <= 1) {
+        body(0, count);
+        return;
+    }
+
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    std::vector<std::future<void>> pending;
+    pending.reserve(chunks);
+    for (size_t begin = chunkSize; begin < count; begin += chunkSize) {
+        size_t end = std::min(begin + chunkSize, count);
+        pending.push_back(submit([&body, begin, end] { body(begin, end); }));
+    }
+    // 调用线程自己处理第一块
+    body(0, std::min(chunkSize, count));
+    for (auto& f : pending) {
+        f.get();
+    }
+}
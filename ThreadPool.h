@@ -0,0 +1,58 @@
+﻿//ThreadPool.h
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+// 固定大小的线程池
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    // 提交任务，返回结果的 future
+    template <typename F>
+    auto submit(F&& f) -> std::future<typename std::result_of<F()>::type> {
+        using R = typename std::result_of<F()>::type;
+        auto job = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> result = job->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            jobs.emplace([job] { (*job)(); });
+        }
+        cv.notify_one();
+        return result;
+    }
+
+    // 把 [0, count) 切成若干块并行执行 body(begin, end)，阻塞直到全部完成
+    // 块数多于线程数，空闲线程会从共享队列领取剩余块，实现动态负载均衡
+    // 不可在本线程池的任务内部调用，否则可能因等待自身队列而死锁
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)>& body, size_t minChunk = 16384);
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> jobs;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+};
+
+
+#endif // THREADPOOL_H
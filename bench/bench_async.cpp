@@ -0,0 +1,63 @@
+﻿//bench_async.cpp
+// 对比同步 TaskManager 与 AsyncTaskManager 的并发吞吐（需要可用的 MySQL，只执行只读查询）
+// 用法: bench_async [操作数，默认2000] [并发连接数，默认8]
+#include "../AsyncTaskManager.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+// 混合点查询和按状态查询，模拟脚本的典型访问
+Task lookup(TaskManager& manager, size_t i) {
+    Task task{};
+    if (i % 4 == 0) {
+        QueryResult result = manager.listTasksByStatus("pending");
+        task.id = static_cast<int>(result.tasks.size());
+    } else {
+        // 绕过点查询缓存，保证每次操作都访问数据库
+        manager.readTaskFromDb(static_cast<int>(i % 100) + 1, task);
+    }
+    return task;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    size_t ops = argc > 1 ? std::stoul(argv[1]) : 2000;
+    size_t concurrency = argc > 2 ? std::stoul(argv[2]) : 8;
+    long sink = 0;
+
+    TaskManager manager;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ops; ++i) {
+        sink += lookup(manager, i).id;
+    }
+    double syncMs = elapsedMs(start);
+
+    AsyncTaskManager async(concurrency);
+    start = std::chrono::steady_clock::now();
+    std::vector<std::future<Task>> pending;
+    pending.reserve(ops);
+    for (size_t i = 0; i < ops; ++i) {
+        pending.push_back(async.submit([i](TaskManager& m) { return lookup(m, i); }));
+    }
+    for (auto& f : pending) {
+        sink += f.get().id;
+    }
+    double asyncMs = elapsedMs(start);
+
+    std::cout << "操作数: " << ops << ", 并发连接数: " << async.concurrency() << std::endl;
+    std::cout << "  同步:   " << syncMs << " ms (" << ops / syncMs * 1000 << " 次/秒)" << std::endl;
+    std::cout << "  异步:   " << asyncMs << " ms (" << ops / asyncMs * 1000 << " 次/秒)" << std::endl;
+    std::cout << "  吞吐提升: " << syncMs / asyncMs << "x" << std::endl;
+    std::cout << "(校验和 " << sink << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,95 @@
+﻿//bench_query.cpp
+// 对比串行与 QueryEngine 并行执行的聚合、状态过滤、三种排序和最近到期任务
+// 用法: bench_query [任务数量，默认1000000] [线程数，默认为CPU核数]
+#include "../QueryEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+
+namespace {
+
+const char* STATUSES[] = {"pending", "in_progress", "completed"};
+
+template <typename F>
+double timeMs(F&& f, int repeat = 5) {
+    double best = 1e300;
+    for (int i = 0; i < repeat; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+void report(const char* name, double serialMs, double parallelMs) {
+    std::cout << "  " << name << ": 串行 " << serialMs << " ms, 并行 " << parallelMs
+              << " ms, 加速比 " << serialMs / parallelMs << std::endl;
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    size_t threads = argc > 2 ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+
+    std::mt19937 rng(42);
+    TaskStore store;
+    store.reserve(n, n * 48);
+    for (size_t i = 0; i < n; ++i) {
+        char date[16];
+        std::snprintf(date, sizeof(date), "2025-%02d-%02d",
+                      1 + static_cast<int>(rng() % 12), 1 + static_cast<int>(rng() % 28));
+        store.upsert(Task{static_cast<int>(i + 1), "任务" + std::to_string(i), "描述",
+                          1 + static_cast<int>(rng() % 3), date, STATUSES[rng() % 3]});
+    }
+
+    ThreadPool serialPool(1);
+    ThreadPool pool(threads);
+    QueryEngine serial(serialPool);
+    QueryEngine parallel(pool);
+    int32_t today = parseDueDate("2025-07-01");
+    size_t sink = 0;
+
+    std::cout << "任务数量: " << n << ", 线程数: " << pool.size() << std::endl;
+    report("聚合报表    ",
+           timeMs([&] { sink += serial.aggregate(store, today).overdue; }),
+           timeMs([&] { sink += parallel.aggregate(store, today).overdue; }));
+    report("按状态过滤  ",
+           timeMs([&] { sink += serial.filterByStatus(store, TaskStatus::Completed).size(); }),
+           timeMs([&] { sink += parallel.filterByStatus(store, TaskStatus::Completed).size(); }));
+    const char* sortNames[] = {"按ID排序    ", "按优先级排序", "按截止日期排序"};
+    for (int option = 0; option < 3; ++option) {
+        if (serial.sortedRows(store, option) != parallel.sortedRows(store, option)) {
+            std::cerr << "并行排序结果不一致: " << sortNames[option] << std::endl;
+            return 1;
+        }
+        report(sortNames[option],
+               timeMs([&] { sink += store.sortedRows(option).front(); }, 3),
+               timeMs([&] { sink += parallel.sortedRows(store, option).front(); }, 3));
+    }
+
+    // 最近到期：与全量排序后过滤的前5个比较
+    std::vector<uint32_t> expected;
+    for (uint32_t row : store.sortedRows(2)) {
+        if (expected.size() == 5) {
+            break;
+        }
+        if (store.status(row) != TaskStatus::Completed && store.dueDay(row) != NO_DUE_DATE) {
+            expected.push_back(row);
+        }
+    }
+    if (parallel.upcoming(store, 5) != expected) {
+        std::cerr << "最近到期任务结果不一致" << std::endl;
+        return 1;
+    }
+    report("最近到期前5 ",
+           timeMs([&] { sink += serial.upcoming(store, 5).front(); }),
+           timeMs([&] { sink += parallel.upcoming(store, 5).front(); }));
+    std::cout << "(校验和 " << sink << ")" << std::endl;
+    return 0;
+}
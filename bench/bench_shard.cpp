@@ -0,0 +1,196 @@
+﻿//bench_shard.cpp
+// 使用内存后端校验 ShardedTaskStore：k路归并结果与单库顺序一致，再平衡迁移的任务数和归属正确，
+// 分片数与记录不一致时拒绝打开
+// 同时对比单库扫描与分片并行扫描+归并的耗时。不依赖 MySQL
+// 用法: bench_shard [任务数量，默认200000] [分片数，默认4] [再平衡后的分片数，默认7]
+#include "../MemoryTaskBackend.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+
+namespace {
+
+const char* STATUSES[] = {"pending", "in_progress", "completed"};
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool sameTasks(const std::vector<Task>& a, const std::vector<Task>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].id != b[i].id || a[i].priority != b[i].priority || a[i].dueDate != b[i].dueDate ||
+            a[i].status != b[i].status) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 持有各分片后端的指针，用于直接检查每个任务是否位于哈希归属的分片
+struct Backends {
+    std::vector<MemoryTaskBackend*> ptrs;
+
+    ShardedTaskStore::BackendFactory factory() {
+        return [this](size_t index) -> std::unique_ptr<TaskBackend> {
+            auto backend = std::make_unique<MemoryTaskBackend>();
+            ptrs.resize(std::max(ptrs.size(), index + 1));
+            ptrs[index] = backend.get();
+            return backend;
+        };
+    }
+};
+
+// 每个分片只包含归属于它的任务，且总数等于 expected
+bool placementValid(Backends& backends, size_t shardCount, size_t expected) {
+    size_t total = 0;
+    for (size_t i = 0; i < shardCount; ++i) {
+        for (const Task& task : backends.ptrs[i]->scan(0, "")) {
+            if (ShardedTaskStore::shardFor(task.id, shardCount) != i) {
+                return false;
+            }
+            ++total;
+        }
+    }
+    return total == expected;
+}
+
+// 用给定的后端构造 ShardedTaskStore，返回是否因分片数不匹配被拒绝
+bool refused(std::vector<std::unique_ptr<MemoryTaskBackend>> backends) {
+    std::vector<std::unique_ptr<TaskBackend>> owned;
+    for (auto& backend : backends) {
+        owned.push_back(std::move(backend));
+    }
+    try {
+        ShardedTaskStore store(std::move(owned));
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// 记录的分片数与实际不一致、或单库数据直接按多分片打开时必须拒绝
+bool layoutChecksValid() {
+    std::vector<std::unique_ptr<MemoryTaskBackend>> wrongCount;
+    for (int i = 0; i < 2; ++i) {
+        wrongCount.push_back(std::make_unique<MemoryTaskBackend>());
+    }
+    wrongCount[0]->storeShardCount(4);
+
+    std::vector<std::unique_ptr<MemoryTaskBackend>> singleData;
+    for (int i = 0; i < 3; ++i) {
+        singleData.push_back(std::make_unique<MemoryTaskBackend>());
+    }
+    singleData[0]->insert(Task{1, "单库任务", "", 2, "", "pending"});
+
+    std::vector<std::unique_ptr<MemoryTaskBackend>> matching;
+    for (int i = 0; i < 4; ++i) {
+        matching.push_back(std::make_unique<MemoryTaskBackend>());
+    }
+    matching[0]->storeShardCount(4);
+
+    return refused(std::move(wrongCount)) && refused(std::move(singleData)) && !refused(std::move(matching));
+}
+
+size_t expectedMoves(const std::vector<Task>& tasks, size_t from, size_t to) {
+    size_t moves = 0;
+    for (const Task& task : tasks) {
+        moves += ShardedTaskStore::shardFor(task.id, from) != ShardedTaskStore::shardFor(task.id, to);
+    }
+    return moves;
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 200000;
+    size_t shardCount = argc > 2 ? std::max<size_t>(std::stoul(argv[2]), 1) : 4;
+    size_t newCount = argc > 3 ? std::max<size_t>(std::stoul(argv[3]), 1) : 7;
+
+    Backends backends;
+    auto factory = backends.factory();
+    std::vector<std::unique_ptr<TaskBackend>> single;
+    single.push_back(std::make_unique<MemoryTaskBackend>());
+    std::vector<std::unique_ptr<TaskBackend>> parts;
+    for (size_t i = 0; i < shardCount; ++i) {
+        parts.push_back(factory(i));
+    }
+    ShardedTaskStore reference(std::move(single));
+    ShardedTaskStore sharded(std::move(parts));
+
+    // 两边写入同样的任务（ID由各自的序列按相同顺序分配），再删除一部分使ID稀疏
+    std::mt19937 rng(42);
+    for (size_t i = 0; i < count; ++i) {
+        int priority = static_cast<int>(rng() % 3) + 1;
+        std::string due = rng() % 10 == 0 ? "" : "2025-" + std::to_string(rng() % 9 + 1) + "-1" + std::to_string(rng() % 10);
+        std::string status = STATUSES[rng() % 3];
+        OpResult a = reference.add("任务" + std::to_string(i), "描述", priority, due);
+        OpResult b = sharded.add("任务" + std::to_string(i), "描述", priority, due);
+        if (a.task.id != b.task.id) {
+            std::cerr << "ID分配不一致: " << a.task.id << " != " << b.task.id << std::endl;
+            return 1;
+        }
+        reference.updateStatus(a.task.id, status);
+        sharded.updateStatus(b.task.id, status);
+    }
+    for (size_t i = 0; i < count / 10; ++i) {
+        int id = static_cast<int>(rng() % count) + 1;
+        reference.remove(id);
+        sharded.remove(id);
+    }
+    std::vector<Task> all = reference.list(0);
+    std::cout << "任务数: " << all.size() << ", 分片数: " << shardCount << std::endl;
+
+    const char* sortNames[] = {"按ID", "按优先级", "按截止日期"};
+    size_t sink = 0;
+    for (int option = 0; option < 3; ++option) {
+        for (const char* status : {"", "in_progress"}) {
+            auto start = std::chrono::steady_clock::now();
+            std::vector<Task> expected = reference.list(option, status);
+            double singleMs = elapsedMs(start);
+            start = std::chrono::steady_clock::now();
+            std::vector<Task> merged = sharded.list(option, status);
+            double shardedMs = elapsedMs(start);
+            if (!sameTasks(expected, merged)) {
+                std::cerr << "归并结果与单库顺序不一致: " << sortNames[option] << " " << status << std::endl;
+                return 1;
+            }
+            std::cout << "  " << sortNames[option] << (*status ? "（过滤 in_progress）" : "")
+                      << ": 单库 " << singleMs << " ms, 分片归并 " << shardedMs << " ms" << std::endl;
+            sink += merged.size();
+        }
+    }
+
+    // 扩容再缩回，两次都检查迁移数量、任务归属和列表结果
+    for (size_t target : {newCount, shardCount}) {
+        size_t from = sharded.shardCount();
+        size_t expected = expectedMoves(all, from, target);
+        auto start = std::chrono::steady_clock::now();
+        size_t moved = sharded.rebalance(target, factory);
+        double rebalanceMs = elapsedMs(start);
+        if (moved != expected || !placementValid(backends, target, all.size()) ||
+            !sameTasks(all, sharded.list(0))) {
+            std::cerr << "再平衡结果错误: " << from << " -> " << target << "，迁移 " << moved
+                      << "，预期 " << expected << std::endl;
+            return 1;
+        }
+        std::cout << "  再平衡 " << from << " -> " << target << ": 迁移 " << moved << " 个任务, "
+                  << rebalanceMs << " ms" << std::endl;
+        sink += moved;
+    }
+
+    if (!layoutChecksValid()) {
+        std::cerr << "分片数检查错误：不匹配的分片数未被拒绝" << std::endl;
+        return 1;
+    }
+
+    std::cout << "校验通过 (校验和 " << sink << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,118 @@
+﻿//bench_startup.cpp
+// 测量 LogSystem 从进程启动到第一条命令执行完成的耗时，对比默认启动与 --fast-start
+// 以单条命令模式运行 "list 0 tsv"，分别记录收到命令第一行输出的时间和进程退出的时间
+// 需要先构建 LogSystem 并有可用的 MySQL
+// 用法: bench_startup [LogSystem 路径，默认./LogSystem] [每种模式运行次数，默认10]
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+namespace {
+
+struct Sample {
+    double firstOutputMs = 0; // 启动到命令开始输出
+    double exitMs = 0;        // 启动到进程退出
+    size_t bytes = 0;
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 启动一次 LogSystem 并读取其标准输出，失败时返回false
+bool runOnce(const std::string& binary, bool fastStart, Sample& sample) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+
+    std::vector<std::string> args = {binary};
+    if (fastStart) {
+        args.push_back("--fast-start");
+    }
+    args.insert(args.end(), {"list", "0", "tsv"});
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        execv(binary.c_str(), argv.data());
+        _exit(127);
+    }
+
+    close(fds[1]);
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(fds[0], buffer, sizeof(buffer))) > 0) {
+        if (sample.bytes == 0) {
+            sample.firstOutputMs = elapsedMs(start);
+        }
+        sample.bytes += static_cast<size_t>(n);
+    }
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    sample.exitMs = elapsedMs(start);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 && sample.bytes > 0;
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values.empty() ? 0 : values[values.size() / 2];
+}
+
+// 运行 runs 次并打印中位数，返回收到的输出字节总数（作为校验和）
+size_t measure(const std::string& binary, bool fastStart, size_t runs) {
+    std::vector<double> firstOutput;
+    std::vector<double> exit;
+    size_t bytes = 0;
+    for (size_t i = 0; i < runs; ++i) {
+        Sample sample;
+        if (!runOnce(binary, fastStart, sample)) {
+            std::cerr << "运行 " << binary << " 失败，请确认已构建且数据库可用。" << std::endl;
+            return bytes;
+        }
+        firstOutput.push_back(sample.firstOutputMs);
+        exit.push_back(sample.exitMs);
+        bytes += sample.bytes;
+    }
+    std::cout << (fastStart ? "  --fast-start: " : "  默认启动:     ")
+              << "首条命令输出 " << median(firstOutput) << " ms，进程退出 " << median(exit) << " ms" << std::endl;
+    return bytes;
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    std::string binary = argc > 1 ? argv[1] : "./LogSystem";
+    size_t runs = argc > 2 ? std::stoul(argv[2]) : 10;
+
+    // 预热一次：建库建表并写入 schema 版本缓存，使两种模式都在已初始化的数据库上比较
+    Sample warmup;
+    runOnce(binary, false, warmup);
+
+    std::cout << "启动耗时（" << runs << " 次运行的中位数，命令: list 0 tsv）:" << std::endl;
+    size_t sink = measure(binary, false, runs);
+    sink += measure(binary, true, runs);
+    std::cout << "(校验和 " << sink << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,128 @@
+﻿//bench_taskstore.cpp
+// 对比 std::vector<Task>（字符串字段）与 TaskStore（SoA + arena）的内存占用、状态过滤和排序速度
+// 用法: bench_taskstore [任务数量，默认1000000]
+#include "../TaskStore.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+const char* STATUSES[] = {"pending", "in_progress", "completed"};
+
+// 估算 std::string 的堆占用（超出 SSO 容量时才分配）
+size_t heapBytes(const std::string& str) {
+    return str.capacity() > 15 ? str.capacity() + 1 : 0;
+}
+
+template <typename F>
+double timeMs(F&& f, int repeat = 5) {
+    double best = 1e300;
+    for (int i = 0; i < repeat; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+void report(const char* name, double ms, size_t n) {
+    std::cout << "  " << name << ": " << ms << " ms ("
+              << (n / ms / 1000.0) << " M任务/秒)" << std::endl;
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    std::mt19937 rng(42);
+    std::vector<Task> tasks;
+    tasks.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        int day = 1 + static_cast<int>(rng() % 28);
+        int month = 1 + static_cast<int>(rng() % 12);
+        char date[16];
+        std::snprintf(date, sizeof(date), "2025-%02d-%02d", month, day);
+        tasks.push_back(Task{static_cast<int>(i + 1),
+                             "任务" + std::to_string(i),
+                             "这是第 " + std::to_string(i) + " 个任务的描述信息",
+                             1 + static_cast<int>(rng() % 3),
+                             date,
+                             STATUSES[rng() % 3]});
+    }
+
+    TaskStore store;
+    store.reserve(n, n * 64);
+    for (const auto& task : tasks) {
+        store.upsert(task);
+    }
+
+    size_t vectorBytes = tasks.capacity() * sizeof(Task);
+    for (const auto& task : tasks) {
+        vectorBytes += heapBytes(task.title) + heapBytes(task.description)
+                     + heapBytes(task.dueDate) + heapBytes(task.status);
+    }
+
+    std::cout << "任务数量: " << n << std::endl;
+    std::cout << "内存占用 (字节/任务):" << std::endl;
+    std::cout << "  std::vector<Task>: " << static_cast<double>(vectorBytes) / n << std::endl;
+    std::cout << "  TaskStore:         " << static_cast<double>(store.memoryUsage()) / n << std::endl;
+
+    size_t sink = 0;
+    std::cout << "按状态过滤 (completed):" << std::endl;
+    report("std::vector<Task>", timeMs([&] {
+        std::vector<uint32_t> rows;
+        for (uint32_t i = 0; i < tasks.size(); ++i) {
+            if (tasks[i].status == "completed") rows.push_back(i);
+        }
+        sink += rows.size();
+    }), n);
+    report("TaskStore        ", timeMs([&] {
+        sink += store.filterByStatus(TaskStatus::Completed).size();
+    }), n);
+    double scanMs = timeMs([&] {
+        size_t count = 0;
+        for (TaskStatus s : store.statusColumn()) count += s == TaskStatus::Completed;
+        sink += count;
+    });
+    std::cout << "  TaskStore 纯计数扫描: " << scanMs << " ms ("
+              << (n * sizeof(TaskStatus) / scanMs / 1e6) << " GB/s)" << std::endl;
+
+    std::cout << "排序 (按截止日期, ID为次序键):" << std::endl;
+    report("std::vector<Task>", timeMs([&] {
+        std::vector<const Task*> order;
+        order.reserve(tasks.size());
+        for (const auto& task : tasks) order.push_back(&task);
+        std::sort(order.begin(), order.end(), [](const Task* a, const Task* b) {
+            return a->dueDate != b->dueDate ? a->dueDate < b->dueDate : a->id < b->id;
+        });
+        sink += order.front()->id;
+    }, 3), n);
+    report("TaskStore        ", timeMs([&] {
+        sink += store.sortedRows(2).front();
+    }, 3), n);
+
+    std::cout << "排序 (按优先级, ID为次序键):" << std::endl;
+    report("std::vector<Task>", timeMs([&] {
+        std::vector<const Task*> order;
+        order.reserve(tasks.size());
+        for (const auto& task : tasks) order.push_back(&task);
+        std::sort(order.begin(), order.end(), [](const Task* a, const Task* b) {
+            return a->priority != b->priority ? a->priority < b->priority : a->id < b->id;
+        });
+        sink += order.front()->id;
+    }, 3), n);
+    report("TaskStore        ", timeMs([&] {
+        sink += store.sortedRows(1).front();
+    }, 3), n);
+
+    std::cout << "(校验和 " << sink << ")" << std::endl;
+    return 0;
+}
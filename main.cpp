@@ -3,31 +3,127 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
-#include "TaskManager.h"
+#include <algorithm>
+#include <cstdlib>
+#include "AsyncTaskManager.h"
 #include "Command.h"
+#include "ChangeFeedServer.h"
+#include "ThreadPool.h"
+#include "Logger.h"
 
 
-int main() {
-    TaskManager taskManager;
+using CommandMap = std::unordered_map<std::string, std::unique_ptr<CommandBase>>;
 
+void printHelp() {
+    std::cout << "可用命令:" << std::endl;
+    std::cout << "add <标题>,<描述>,<优先级>,<截止日期> - 添加新任务" << std::endl;
+    std::cout << "delete <ID> - 删除任务" << std::endl;
+    std::cout << "list [排序选项] [格式] - 列出任务(0=按ID,1=按优先级,2=按截止日期; 格式: table/tsv/json)" << std::endl;
+    std::cout << "filter <状态> [格式] - 列出指定状态的任务" << std::endl;
+    std::cout << "update <ID>,<标题>,<描述>,<优先级>,<截止日期> - 更新任务" << std::endl;
+    std::cout << "status <ID>,<状态> - 更新任务状态" << std::endl;
+    std::cout << "watch [偏移量] - 查看任务变更流(省略偏移量时从上次位置继续)" << std::endl;
+    std::cout << "report [YYYY-MM-DD] - 按状态/优先级统计任务及逾期数量" << std::endl;
+    std::cout << "cache - 查看点查询缓存命中率等统计" << std::endl;
+    std::cout << "exit - 退出程序" << std::endl;
+}
+
+void printUsage() {
+    std::cout << "用法: LogSystem [--shards=N] [--fast-start] [命令 [参数...]]" << std::endl;
+    std::cout << "  --shards=N   按ID哈希把任务分布到N个库（默认1，即单库）" << std::endl;
+    std::cout << "  --fast-start 首次使用时才连接数据库，schema 版本缓存一致时跳过DDL" << std::endl;
+    std::cout << "  给出命令时只执行这一条命令后退出，例如: LogSystem --fast-start list 1 tsv" << std::endl;
+}
+
+// 分离命令和参数并执行（交互模式和单条命令模式共用），未知命令或执行失败时返回false
+bool executeLine(const CommandMap& commands, const std::string& input) {
+    size_t spacePos = input.find(' ');
+    std::string cmd = input.substr(0, spacePos);
+    std::string args;
+    if (spacePos != std::string::npos) {
+        args = input.substr(spacePos + 1);
+    }
+
+    if (cmd == "help") {
+        printHelp();
+        return true;
+    }
+    auto it = commands.find(cmd);
+    if (it == commands.end()) {
+        std::cout << "未知命令：" << cmd << std::endl;
+        return false;
+    }
+    try {
+        return it->second->execute(args);
+    } catch (const std::exception&) {
+        // 个别命令用 std::stoi 解析数字参数，格式错误时抛出异常
+        std::cout << "参数格式错误，输入 help 查看用法。" << std::endl;
+        return false;
+    }
+}
+
+
+int main(int argc, char* argv[]) {
+    // 命令行参数见 printUsage；选项必须写在命令之前，命令开始后的参数原样交给命令
+    size_t shardCount = 1;
+    bool fastStart = false;
+    std::string oneShot;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!oneShot.empty()) {
+            oneShot += " " + arg;
+        } else if (arg.compare(0, 9, "--shards=") == 0) {
+            shardCount = std::max(1, std::atoi(arg.c_str() + 9));
+        } else if (arg == "--fast-start") {
+            fastStart = true;
+        } else if (arg.compare(0, 1, "-") == 0) {
+            std::cerr << "未知选项：" << arg << std::endl;
+            printUsage();
+            return 1;
+        } else {
+            oneShot = arg;
+        }
+    }
+    if (oneShot == "exit") {
+        return 0;
+    }
 
-    // 创建命令对象
-    AddCommand addCmd(taskManager);
-    DeleteCommand delCmd(taskManager);
-    ListCommand listCmd(taskManager);
-    UpdateCommand updateCmd(taskManager);
-    UpdateStatusCommand statusCmd(taskManager); 
+    Logger::getInstance(); // 尽早在后台打开日志文件
+    std::unique_ptr<AsyncTaskManager> manager;
+    try {
+        manager = std::make_unique<AsyncTaskManager>(4, shardCount, fastStart);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    AsyncTaskManager& taskManager = *manager; // 命令行只是异步接口的一个客户端
+    ThreadPool queryPool; // 报表查询使用的计算线程池
 
     // 命令映射
-    std::unordered_map<std::string, std::unique_ptr<CommandBase>> commands;
+    CommandMap commands;
     commands["add"] = std::make_unique<AddCommand>(taskManager);
     commands["delete"] = std::make_unique<DeleteCommand>(taskManager);
     commands["list"] = std::make_unique<ListCommand>(taskManager);
+    commands["filter"] = std::make_unique<FilterCommand>(taskManager);
     commands["update"] = std::make_unique<UpdateCommand>(taskManager);
     commands["status"] = std::make_unique<UpdateStatusCommand>(taskManager); // 注册状态命令
+    commands["watch"] = std::make_unique<WatchCommand>();
+    commands["report"] = std::make_unique<ReportCommand>(taskManager, queryPool);
+    commands["cache"] = std::make_unique<CacheCommand>(taskManager);
+
+    // 单条命令模式：不启动变更流服务，也不进入交互循环
+    if (!oneShot.empty()) {
+        return executeLine(commands, oneShot) ? 0 : 1;
+    }
+
+    // 本地套接字变更流，供外部工具增量订阅
+    ChangeFeedServer feedServer("task_feed.sock");
+    if (!feedServer.start()) {
+        std::cerr << "变更流服务启动失败，watch 命令仍可使用。" << std::endl;
+    }
     
     std::cout << "欢迎使用任务管理系统！" << std::endl;
-    std::cout << "可用命令: add, delete, list, update, status, exit" << std::endl;
+    std::cout << "可用命令: add, delete, list, filter, update, status, watch, report, cache, exit" << std::endl;
     std::cout << "使用 'status <ID>,<状态>' 来更新任务状态" << std::endl;
     std::cout << "可用状态: pending(待处理), in_progress(进行中), completed(已完成)" << std::endl;
 
@@ -39,37 +135,13 @@ int main() {
         if (input.empty()) continue;
 
 
-        // 分离命令和参数
-        size_t spacePos = input.find(' ');
-        std::string cmd = input.substr(0, spacePos);
-        std::string args;
-        if (spacePos != std::string::npos) {
-            args = input.substr(spacePos + 1);
-        }
-
-
+        std::string cmd = input.substr(0, input.find(' '));
         if (cmd == "exit") {
             std::cout << "退出程序。" << std::endl;
             break;
         }
         
-        if (cmd == "help") {
-            std::cout << "可用命令:" << std::endl;
-            std::cout << "add <标题>,<描述>,<优先级>,<截止日期> - 添加新任务" << std::endl;
-            std::cout << "delete <ID> - 删除任务" << std::endl;
-            std::cout << "list [排序选项] - 列出任务(0=按ID,1=按优先级,2=按截止日期)" << std::endl;
-            std::cout << "update <ID>,<标题>,<描述>,<优先级>,<截止日期> - 更新任务" << std::endl;
-            std::cout << "status <ID>,<状态> - 更新任务状态" << std::endl;
-            std::cout << "exit - 退出程序" << std::endl;
-            continue;
-        }
-
-        auto it = commands.find(cmd);
-        if (it != commands.end()) {
-            it->second->execute(args);
-        } else {
-            std::cout << "未知命令：" << cmd << std::endl;
-        }
+        executeLine(commands, input);
     }
 
 